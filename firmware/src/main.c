@@ -40,6 +40,7 @@ void app_main(void) {
   // Core setup
   init_i2c();
   settings_init();
+  peers_init();
   init_adcs();
   buttons_init();
   buzzer_init();
@@ -11,6 +11,20 @@
 #define STICK_DEADBAND 10
 #define STICK_EXPO 1
 #define INVERT_Y_AXIS false
+// Raw reads per axis every input cycle, reduced with a median
+#ifndef STICK_OVERSAMPLE_COUNT
+  #define STICK_OVERSAMPLE_COUNT 8
+#endif
+// Low pass applied to the median of each cycle, 0 disables it. Each step of shift adds input cycles of lag to a full
+// throw.
+#ifndef STICK_FILTER_SHIFT
+  #define STICK_FILTER_SHIFT 0
+#endif
+// Codes the stick has to move past a 0.01 step boundary before the axis takes the next step, so noise on a stick held
+// at a boundary doesn't toggle between the two steps
+#ifndef STICK_HYSTERESIS
+  #define STICK_HYSTERESIS 6
+#endif
 
 extern const adc_oneshot_chan_cfg_t adc_channel_config;
 
@@ -0,0 +1,167 @@
+#include "channel_planner.h"
+#include "esp_log.h"
+#include "settings.h"
+#include <freertos/FreeRTOS.h>
+#include <stdbool.h>
+#include <string.h>
+
+static const char *TAG = "PUBREMOTE-CHANNEL_PLANNER";
+
+#define CHANNEL_HISTORY_KEY "chan_hist"
+// Dwell times per search entry
+#define LAST_GOOD_DWELL_MS 400
+#define KNOWN_DWELL_MS 200
+#define UNKNOWN_DWELL_MS 120
+// After a full pass without finding the peer every channel gets the known dwell
+#define RETRY_DWELL_MS 200
+// Dwell on the last good channel between probes while reconnecting
+#define REVISIT_DWELL_MS 200
+// Halve all counts once one reaches this, so old history fades out
+#define MAX_CHANNEL_SUCCESSES 1000
+
+typedef struct {
+  uint16_t successes;
+  int8_t rssi; // Smoothed RSSI of successful connections
+} ChannelHistory;
+
+// Indexed by channel - 1, persisted in NVS
+static ChannelHistory channel_history[CHANNEL_PLANNER_NUM_CHANNELS];
+static portMUX_TYPE channel_history_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Receiver task state
+static uint8_t search_order[CHANNEL_PLANNER_NUM_CHANNELS];
+static uint8_t search_index = 0;
+static uint16_t search_pass = 0;
+// Set while reconnecting, every probe of another channel is followed by a return to the last good channel
+static bool is_revisiting = false;
+static bool is_on_last_good = false;
+
+void channel_planner_init() {
+  if (nvs_read_blob(CHANNEL_HISTORY_KEY, channel_history, sizeof(channel_history)) != ESP_OK) {
+    memset(channel_history, 0, sizeof(channel_history));
+  }
+}
+
+// Higher is tried earlier
+static int32_t get_channel_score(const ChannelHistory *history) {
+  if (history->successes == 0) {
+    return INT32_MIN;
+  }
+
+  // RSSI only breaks ties between channels with the same number of connections
+  return (int32_t)history->successes * 256 + (history->rssi + 128);
+}
+
+void channel_planner_start(uint8_t last_good_channel, bool is_reconnecting) {
+  ChannelHistory history[CHANNEL_PLANNER_NUM_CHANNELS];
+
+  taskENTER_CRITICAL(&channel_history_lock);
+  memcpy(history, channel_history, sizeof(history));
+  taskEXIT_CRITICAL(&channel_history_lock);
+
+  uint8_t first = 0;
+  if (last_good_channel >= 1 && last_good_channel <= CHANNEL_PLANNER_NUM_CHANNELS) {
+    search_order[first++] = last_good_channel;
+  }
+
+  // The search starts on the last good channel
+  is_revisiting = is_reconnecting && first > 0;
+  is_on_last_good = is_revisiting;
+
+  // Insertion sort of the remaining channels by score, stable so unknown channels keep their natural order
+  uint8_t count = first;
+  for (uint8_t channel = 1; channel <= CHANNEL_PLANNER_NUM_CHANNELS; channel++) {
+    if (channel == last_good_channel) {
+      continue;
+    }
+
+    int32_t score = get_channel_score(&history[channel - 1]);
+    uint8_t position = count;
+    while (position > first && get_channel_score(&history[search_order[position - 1] - 1]) < score) {
+      search_order[position] = search_order[position - 1];
+      position--;
+    }
+
+    search_order[position] = channel;
+    count++;
+  }
+
+  search_index = 0;
+  search_pass = 0;
+}
+
+uint8_t channel_planner_next() {
+  if (is_revisiting && !is_on_last_good) {
+    is_on_last_good = true;
+    return search_order[0];
+  }
+  is_on_last_good = false;
+
+  search_index++;
+
+  if (search_index >= CHANNEL_PLANNER_NUM_CHANNELS) {
+    // The revisits already cover the last good channel
+    search_index = is_revisiting ? 1 : 0;
+    search_pass++;
+  }
+
+  return search_order[search_index];
+}
+
+uint32_t channel_planner_get_dwell_ms() {
+  if (is_on_last_good && search_index > 0) {
+    return REVISIT_DWELL_MS;
+  }
+
+  if (search_pass > 0) {
+    return RETRY_DWELL_MS;
+  }
+
+  if (search_index == 0) {
+    return LAST_GOOD_DWELL_MS;
+  }
+
+  uint8_t channel = search_order[search_index];
+  taskENTER_CRITICAL(&channel_history_lock);
+  bool is_known = channel_history[channel - 1].successes > 0;
+  taskEXIT_CRITICAL(&channel_history_lock);
+
+  return is_known ? KNOWN_DWELL_MS : UNKNOWN_DWELL_MS;
+}
+
+void channel_planner_record_success(uint8_t channel, int rssi) {
+  if (channel < 1 || channel > CHANNEL_PLANNER_NUM_CHANNELS) {
+    return;
+  }
+
+  if (rssi < INT8_MIN) {
+    rssi = INT8_MIN;
+  }
+  else if (rssi > INT8_MAX) {
+    rssi = INT8_MAX;
+  }
+
+  taskENTER_CRITICAL(&channel_history_lock);
+  ChannelHistory *history = &channel_history[channel - 1];
+  history->rssi = history->successes == 0 ? rssi : (history->rssi * 3 + rssi) / 4;
+  history->successes++;
+
+  if (history->successes >= MAX_CHANNEL_SUCCESSES) {
+    for (int i = 0; i < CHANNEL_PLANNER_NUM_CHANNELS; i++) {
+      channel_history[i].successes /= 2;
+    }
+  }
+  taskEXIT_CRITICAL(&channel_history_lock);
+
+  ESP_LOGI(TAG, "Connected on channel %d, RSSI %d", channel, rssi);
+
+  // Called on connect only, so the NVS write rate stays low
+  ChannelHistory snapshot[CHANNEL_PLANNER_NUM_CHANNELS];
+  taskENTER_CRITICAL(&channel_history_lock);
+  memcpy(snapshot, channel_history, sizeof(snapshot));
+  taskEXIT_CRITICAL(&channel_history_lock);
+
+  if (nvs_write_blob(CHANNEL_HISTORY_KEY, snapshot, sizeof(snapshot)) != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to save channel history");
+  }
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef __CHANNEL_PLANNER_H
+#define __CHANNEL_PLANNER_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define CHANNEL_PLANNER_NUM_CHANNELS 14
+
+// Orders the channel search while connecting or pairing: the last good channel first, then channels ranked by past
+// connections and their RSSI, then the remaining channels. Channels more likely to succeed get a longer dwell.
+// Reconnecting after a lost link goes back to the last good channel between probes, since a fade at the edge of range
+// usually ends on the channel it started on.
+void channel_planner_init();
+void channel_planner_start(uint8_t last_good_channel, bool is_reconnecting);
+uint8_t channel_planner_next();
+uint32_t channel_planner_get_dwell_ms();
+void channel_planner_record_success(uint8_t channel, int rssi);
+
+#endif
@@ -1,9 +1,12 @@
 #include "commands.h"
 #include "connection.h"
+#include "link_stats.h"
 #include "powermanagement.h"
 #include "settings.h"
 #include "stats.h"
+#include "telemetry.h"
 #include "time.h"
+#include "utilities/buffer_utils.h"
 #include "utilities/conversion_utils.h"
 #include <esp_log.h>
 #include <math.h>
@@ -11,76 +14,144 @@
 
 static const char *TAG = "PUBREMOTE-COMMANDS";
 #define PUBMOTE_COMMANDS_DEBUG 0
+#define SECRET_CODE_SIZE 4
+#define CORE_DATA_SIZE 32
 
-bool process_board_data(uint8_t *data, int len) {
-  if ((connection_state == CONNECTION_STATE_CONNECTED || connection_state == CONNECTION_STATE_RECONNECTING ||
-       connection_state == CONNECTION_STATE_CONNECTING) &&
-      len == 32) {
-    reset_sleep_timer();
-    remoteStats.lastUpdated = get_current_time_ms();
-    int32_t super_secret_code = (int32_t)((data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+static bool is_accepting_board_data() {
+  return connection_state == CONNECTION_STATE_CONNECTED || connection_state == CONNECTION_STATE_RECONNECTING ||
+         connection_state == CONNECTION_STATE_CONNECTING;
+}
 
-    if (super_secret_code == pairing_settings.secret_code) {
-      uint8_t fault_code = data[4];
-      float pitch_angle = (int16_t)((data[5] << 8) | data[6]) / 10.0;
-      float roll_angle = (int16_t)((data[7] << 8) | data[8]) / 10.0;
-      float input_voltage_filtered = (int16_t)((data[11] << 8) | data[12]) / 10.0;
-      int16_t rpm = (int16_t)((data[13] << 8) | data[14]);
-      float tot_current = (int16_t)((data[17] << 8) | data[18]) / 10.0;
+static bool check_secret_code(uint8_t *data, int64_t now) {
+  int32_t ind = 0;
+  int32_t super_secret_code = buffer_get_int32(data, &ind);
 
-      // Get RemoteStats
-      float speed = (int16_t)((data[15] << 8) | data[16]) / 10.0;
-      remoteStats.speed = convert_ms_to_kph(fabs(speed));
+  if (super_secret_code != pairing_settings.secret_code) {
+    // Still counts as traffic from the board for connection tracking
+    RemoteStats *stats = stats_begin_update();
+    stats->lastUpdated = now;
+    stats_publish();
+    connection_notify_frame();
 
-      float battery_level = (float)data[30] / 2.0;
+    ESP_LOGE(TAG, "Super secret code mismatch: %li != %li", super_secret_code, pairing_settings.secret_code);
+    return false;
+  }
 
-      remoteStats.batteryPercentage = battery_level;
-      remoteStats.batteryVoltage = input_voltage_filtered;
-      float duty_cycle_now = (float)data[19] / 100.0 - 0.5;
-      remoteStats.dutyCycle = (uint8_t)(fabs(duty_cycle_now) * 100);
+  return true;
+}
 
-      float motor_temp_filtered = (float)data[25] / 2.0;
-      remoteStats.motorTemp = motor_temp_filtered;
+static void publish_board_data(const TelemetryData *telemetry, int64_t now) {
+  // Publish RemoteStats
+  RemoteStats *stats = stats_begin_update();
+  stats->lastUpdated = now;
+  stats->speed = convert_ms_to_kph(fabs(telemetry->speed));
+  stats->batteryPercentage = telemetry->battery_level;
+  stats->batteryVoltage = telemetry->battery_voltage;
+  stats->dutyCycle = (uint8_t)(fabs(telemetry->duty_cycle) * 100);
+  stats->motorTemp = telemetry->motor_temp;
+  stats->controllerTemp = telemetry->controller_temp;
+  stats->state = telemetry->state;
+  stats->switchState = telemetry->switch_state;
+  stats->tripDistance = telemetry->trip_distance;
+  stats->motorCurrent = telemetry->current;
+  stats->rpm = telemetry->rpm;
+  stats->odometer = telemetry->odometer;
+  stats->faultCode = telemetry->fault_code;
+  stats_publish();
+  connection_notify_frame();
 
-      float fet_temp_filtered = (float)data[24] / 2.0;
-      remoteStats.controllerTemp = fet_temp_filtered;
+#if PUBMOTE_COMMANDS_DEBUG
+  // Print the extracted values
+  ESP_LOGI(TAG, "Fault Code: %d", telemetry->fault_code);
+  ESP_LOGI(TAG, "Pitch Angle: %.1f", telemetry->pitch);
+  ESP_LOGI(TAG, "Roll Angle: %.1f", telemetry->roll);
+  ESP_LOGI(TAG, "State: %d", telemetry->state);
+  ESP_LOGI(TAG, "Switch State: %d", telemetry->switch_state);
+  ESP_LOGI(TAG, "Input Voltage Filtered: %.1f", telemetry->battery_voltage);
+  ESP_LOGI(TAG, "RPM: %d", telemetry->rpm);
+  ESP_LOGI(TAG, "Speed: %.1f", telemetry->speed);
+  ESP_LOGI(TAG, "Total Current: %.1f", telemetry->current);
+  ESP_LOGI(TAG, "Duty Cycle Now: %.2f", telemetry->duty_cycle);
+  ESP_LOGI(TAG, "Distance Absolute: %.2f", telemetry->trip_distance);
+  ESP_LOGI(TAG, "FET Temperature Filtered: %.1f", telemetry->controller_temp);
+  ESP_LOGI(TAG, "Motor Temperature Filtered: %.1f", telemetry->motor_temp);
+  ESP_LOGI(TAG, "Odometer: %lu", telemetry->odometer);
+  ESP_LOGI(TAG, "Battery Level: %.1f", telemetry->battery_level);
+#endif
+}
 
-      uint8_t state = data[9];
-      remoteStats.state = state;
-      uint8_t switch_state = data[10];
-      remoteStats.switchState = switch_state;
+// data starts with the secret code
+bool decode_board_data(const uint8_t *data, int len, TelemetryData *telemetry) {
+  if (len != CORE_DATA_SIZE) {
+    return false;
+  }
 
-      float distance_abs;
-      memcpy(&distance_abs, &data[20], sizeof(float));
-      remoteStats.tripDistance = distance_abs;
-      uint32_t odometer = (uint32_t)((data[26] << 24) | (data[27] << 16) | (data[28] << 8) | data[29]);
+  // Fields in wire order, the length check above covers every read
+  int32_t ind = SECRET_CODE_SIZE;
+  telemetry->fault_code = data[ind++];
+  telemetry->pitch = buffer_get_int16(data, &ind) / 10.0;
+  telemetry->roll = buffer_get_int16(data, &ind) / 10.0;
+  telemetry->state = data[ind++];
+  telemetry->switch_state = data[ind++];
+  telemetry->battery_voltage = buffer_get_int16(data, &ind) / 10.0;
+  telemetry->rpm = buffer_get_int16(data, &ind);
+  telemetry->speed = buffer_get_int16(data, &ind) / 10.0;
+  telemetry->current = buffer_get_int16(data, &ind) / 10.0;
+  telemetry->duty_cycle = (float)data[ind++] / 100.0 - 0.5;
+  memcpy(&telemetry->trip_distance, &data[ind], sizeof(float));
+  ind += sizeof(float);
+  telemetry->controller_temp = (float)data[ind++] / 2.0;
+  telemetry->motor_temp = (float)data[ind++] / 2.0;
+  telemetry->odometer = buffer_get_uint32(data, &ind);
+  telemetry->battery_level = (float)data[ind++] / 2.0;
+  return true;
+}
 
-#if PUBMOTE_COMMANDS_DEBUG
-      // Print the extracted values
-      ESP_LOGI(TAG, "Fault Code: %d", fault_code);
-      ESP_LOGI(TAG, "Pitch Angle: %.1f", pitch_angle);
-      ESP_LOGI(TAG, "Roll Angle: %.1f", roll_angle);
-      ESP_LOGI(TAG, "State: %d", state);
-      ESP_LOGI(TAG, "Switch State: %d", switch_state);
-      ESP_LOGI(TAG, "Input Voltage Filtered: %.1f", input_voltage_filtered);
-      ESP_LOGI(TAG, "RPM: %d", rpm);
-      ESP_LOGI(TAG, "Speed: %.1f", speed);
-      ESP_LOGI(TAG, "Total Current: %.1f", tot_current);
-      ESP_LOGI(TAG, "Duty Cycle Now: %.2f", duty_cycle_now);
-      ESP_LOGI(TAG, "Distance Absolute: %.2f", distance_abs);
-      ESP_LOGI(TAG, "FET Temperature Filtered: %.1f", fet_temp_filtered);
-      ESP_LOGI(TAG, "Motor Temperature Filtered: %.1f", motor_temp_filtered);
-      ESP_LOGI(TAG, "Odometer: %lu", odometer);
-      ESP_LOGI(TAG, "Battery Level: %.1f", battery_level);
-#endif
+bool process_board_data(uint8_t *data, int len) {
+  if (is_accepting_board_data() && len == CORE_DATA_SIZE) {
+    reset_sleep_timer();
+    int64_t now = get_current_time_ms();
 
-      stats_update();
-      return true;
+    if (!check_secret_code(data, now)) {
+      return false; // Secret code mismatch
     }
-    else {
-      ESP_LOGE(TAG, "Super secret code mismatch: %li != %li", super_secret_code, pairing_settings.secret_code);
+
+    TelemetryData telemetry;
+    decode_board_data(data, len, &telemetry);
+    publish_board_data(&telemetry, now);
+    return true;
+  }
+  return false;
+}
+
+bool process_telemetry_data(uint8_t *data, int len) {
+  if (is_accepting_board_data() && len > SECRET_CODE_SIZE) {
+    reset_sleep_timer();
+    int64_t now = get_current_time_ms();
+
+    if (!check_secret_code(data, now)) {
       return false; // Secret code mismatch
     }
+
+    TelemetryData telemetry;
+    uint8_t sequence;
+    TelemetryDecodeResult result =
+        telemetry_decode(data + SECRET_CODE_SIZE, len - SECRET_CODE_SIZE, &sequence, &telemetry);
+    if (result != TELEMETRY_DECODE_OK && result != TELEMETRY_DECODE_MISSING_KEYFRAME) {
+      return false;
+    }
+
+    if (!link_stats_record_rx_sequence(sequence)) {
+      // Redundant copy of a frame we already handled
+      return false;
+    }
+
+    if (result != TELEMETRY_DECODE_OK) {
+      return false;
+    }
+
+    publish_board_data(&telemetry, now);
+    return true;
   }
   return false;
 }
\ No newline at end of file
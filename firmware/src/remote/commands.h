@@ -1,6 +1,7 @@
 #ifndef __COMMANDS_H
 #define __COMMANDS_H
 
+#include "telemetry.h"
 #include <stdbool.h>
 #include <stdio.h>
 
@@ -9,16 +10,31 @@ typedef enum {
   REM_VERSION = 0,
   // Receiver version commands
   REM_RECEIVER_VERSION = 5,
+  REM_RECEIVER_CAPABILITIES = 6,
   // Pairing commands
   REM_PAIR_INIT = 10,
   REM_PAIR_BOND = 11,
   REM_PAIR_COMPLETE = 12,
   // Remote specific commands
   REM_SET_CORE_DATA = 100,
+  REM_SET_TELEMETRY = 101,
   // Receiver specific commands
   REM_SET_INPUT_STATE = 150,
+  REM_SET_INPUT_STATE_PACKED = 151,
 } RemoteCommands;
 
+// Flags carried by REM_RECEIVER_CAPABILITIES, features are only used once the receiver advertises them. The payload is
+// [capabilities u8][secret code i32], frames without the paired secret code are ignored.
+typedef enum {
+  RECEIVER_CAPABILITY_PACKED_INPUT = 1 << 0,
+  // Right after advertising this the receiver switches the remote's peer entry to the key from session_key.h, and the
+  // remote does the same for the receiver. Later frames are encrypted by ESP-NOW, which is only as strong as the
+  // pairing secret the key comes from, see session_key.h. Once on, it stays on until the connection drops.
+  RECEIVER_CAPABILITY_ENCRYPTION = 1 << 1,
+} ReceiverCapabilities;
+
+bool decode_board_data(const uint8_t *data, int len, TelemetryData *telemetry);
 bool process_board_data(uint8_t *data, int len);
+bool process_telemetry_data(uint8_t *data, int len);
 
 #endif
\ No newline at end of file
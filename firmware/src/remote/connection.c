@@ -1,13 +1,18 @@
 #include "connection.h"
+#include "channel_planner.h"
 #include "esp_event.h"
 #include "esp_log.h"
 #include "esp_now.h"
 #include "esp_system.h"
 #include "esp_wifi.h"
+#include "link_health.h"
+#include "link_stats.h"
+#include "peer_manager.h"
 #include "peers.h"
 #include "receiver.h"
 #include "remoteinputs.h"
 #include "stats.h"
+#include "telemetry.h"
 #include "time.h"
 #include "transmitter.h"
 #include "ui/ui.h"
@@ -19,67 +24,127 @@
 #include <string.h>
 
 static const char *TAG = "PUBREMOTE-CONNECTION";
-#define CONNECTION_TIMER_DELAY_MS 20
-#define RECONNECTING_DURATION_MS 1000
-#define TIMEOUT_DURATION_MS 30000
+
+// Task notification bits, events that arrive together are handled in this order
+#define CONNECTION_NOTIFY_FRAME (1 << 0)
+#define CONNECTION_NOTIFY_TIMEOUT (1 << 1)
 
 static TaskHandle_t connection_task_handle = NULL;
 ConnectionState connection_state = CONNECTION_STATE_DISCONNECTED;
 PairingState pairing_state = PAIRING_STATE_UNPAIRED;
-static int64_t last_connection_state_change = 0;
+// Serializes events from the connection task and user commands
+static SemaphoreHandle_t connection_mutex = NULL;
+static esp_timer_handle_t connection_timer = NULL;
+// When the armed timer is due, 0 if stopped. A timeout seen before this was re-armed in the meantime.
+static int64_t timer_deadline_ms = 0;
 
-void connection_update_state(ConnectionState state) {
+static void update_state(ConnectionState state) {
   connection_state = state;
-  last_connection_state_change = get_current_time_ms();
 
   if (connection_state == CONNECTION_STATE_DISCONNECTED) {
     // Reset all stats when moving to disconnected state
     stats_init();
   }
   else if (connection_state == CONNECTION_STATE_RECONNECTING) {
-    remoteStats.signalStrength = -255;
+    RemoteStats *stats = stats_begin_update();
+    stats->signalStrength = -255;
+    stats_publish();
+  }
+
+  stats_update(STATS_FIELD_CONNECTION);
+}
+
+static void arm_timer(uint32_t timer_ms) {
+  esp_timer_stop(connection_timer);
+  timer_deadline_ms = 0;
+
+  if (timer_ms > 0) {
+    timer_deadline_ms = get_current_time_ms() + timer_ms;
+    esp_timer_start_once(connection_timer, (uint64_t)timer_ms * 1000);
   }
+}
+
+static void save_connection() {
+  RemoteStats stats;
+  stats_read_snapshot(&stats);
 
-  stats_update();
+  // Save pairing data. This way we remember the last channel we connected on
+  save_pairing_data();
+  peers_save_active();
+  channel_planner_record_success(pairing_settings.channel, stats.signalStrength);
 }
 
-// Use task rather than a timer so we can do heavy lifting in here
+static void handle_event(ConnectionEvent event) {
+  // Nothing to connect or disconnect before connection_init
+  if (connection_mutex == NULL || xSemaphoreTake(connection_mutex, portMAX_DELAY) != pdTRUE) {
+    return;
+  }
+
+  if (event == CONNECTION_EVENT_TIMEOUT && (timer_deadline_ms == 0 || get_current_time_ms() < timer_deadline_ms)) {
+    // Timer was stopped or re-armed after it fired
+    xSemaphoreGive(connection_mutex);
+    return;
+  }
+
+  if (event == CONNECTION_EVENT_TIMEOUT && connection_state == CONNECTION_STATE_CONNECTED) {
+    // Silent while connected, ride out a fade but start looking for the receiver early on a real loss
+    event = link_health_assess(esp_timer_get_time()) == LINK_HEALTH_LOST ? CONNECTION_EVENT_LINK_LOST
+                                                                          : CONNECTION_EVENT_LINK_FADE;
+  }
+  else if (event == CONNECTION_EVENT_CONNECT) {
+    link_health_reset();
+  }
+
+  ConnectionTransition transition = connection_fsm_transition(connection_state, event);
+  arm_timer(transition.timer_ms);
+
+  // New connection or lost receiver, its sequence and keyframe may have restarted by the time we hear it again
+  if (event == CONNECTION_EVENT_CONNECT ||
+      (transition.state == CONNECTION_STATE_RECONNECTING && connection_state != CONNECTION_STATE_RECONNECTING)) {
+    link_stats_reset_rx_sequence();
+    telemetry_reset();
+  }
+
+  // Frames while connected only re-arm the timer
+  if (transition.state != connection_state || event == CONNECTION_EVENT_CONNECT) {
+    ESP_LOGD(TAG, "Connection state %d -> %d", connection_state, transition.state);
+    update_state(transition.state);
+  }
+
+  xSemaphoreGive(connection_mutex);
+
+  // Flash writes stay outside the lock
+  if (transition.actions & CONNECTION_ACTION_SAVE_PAIRING) {
+    save_connection();
+  }
+}
+
+static void connection_timer_callback(void *arg) {
+  if (connection_task_handle != NULL) {
+    xTaskNotify(connection_task_handle, CONNECTION_NOTIFY_TIMEOUT, eSetBits);
+  }
+}
+
+// Called from the receiver task for every frame of board data from the active receiver
+void connection_notify_frame() {
+  if (connection_task_handle != NULL && connection_state != CONNECTION_STATE_DISCONNECTED) {
+    xTaskNotify(connection_task_handle, CONNECTION_NOTIFY_FRAME, eSetBits);
+  }
+}
+
+// Use task rather than the timer callback so we can do heavy lifting in here. Sleeps until an event arrives.
 static void connection_task(void *pvParameters) {
   while (1) {
-    if (connection_state == CONNECTION_STATE_DISCONNECTED) {
-      // Do nothing
-    }
-    else if (connection_state == CONNECTION_STATE_CONNECTED) {
-      if (get_current_time_ms() - remoteStats.lastUpdated > RECONNECTING_DURATION_MS) {
-        // No data received for a while - update connection state
-        connection_update_state(CONNECTION_STATE_RECONNECTING);
-      }
-    }
-    else if (connection_state == CONNECTION_STATE_CONNECTING) {
-      if (get_current_time_ms() - last_connection_state_change > TIMEOUT_DURATION_MS) {
-        // Never connected - reset the connection state
-        connection_update_state(CONNECTION_STATE_DISCONNECTED);
-      }
-      else if (remoteStats.lastUpdated > 0 &&
-               get_current_time_ms() - remoteStats.lastUpdated < RECONNECTING_DURATION_MS) {
-        // Connected - update connection state
-        connection_update_state(CONNECTION_STATE_CONNECTED);
-        // Save pairing data. This way we remember the last channel we connected on
-        save_pairing_data();
-      }
-    }
-    else if (connection_state == CONNECTION_STATE_RECONNECTING) {
-      if (get_current_time_ms() - last_connection_state_change > TIMEOUT_DURATION_MS) {
-        // Reconnect failed - reset the connection state
-        connection_update_state(CONNECTION_STATE_DISCONNECTED);
-      }
-      else if (get_current_time_ms() - remoteStats.lastUpdated < RECONNECTING_DURATION_MS) {
-        // Reconnected - update connection state
-        connection_update_state(CONNECTION_STATE_CONNECTED);
-      }
+    uint32_t notified = 0;
+    xTaskNotifyWait(0, UINT32_MAX, &notified, portMAX_DELAY);
+
+    if (notified & CONNECTION_NOTIFY_FRAME) {
+      handle_event(CONNECTION_EVENT_FRAME);
     }
 
-    vTaskDelay(pdMS_TO_TICKS(CONNECTION_TIMER_DELAY_MS));
+    if (notified & CONNECTION_NOTIFY_TIMEOUT) {
+      handle_event(CONNECTION_EVENT_TIMEOUT);
+    }
   }
 
   // The task will not reach this point as it runs indefinitely
@@ -87,23 +152,23 @@ static void connection_task(void *pvParameters) {
   vTaskDelete(NULL);
 }
 
+void connection_disconnect() {
+  handle_event(CONNECTION_EVENT_DISCONNECT);
+}
+
 void connection_connect_to_peer(uint8_t *mac_addr, uint8_t channel) {
-  esp_now_peer_info_t peerInfo = {};
-  peerInfo.channel = channel; // Set the channel number (0-14)
-  peerInfo.encrypt = false;
-  memcpy(peerInfo.peer_addr, mac_addr, ESP_NOW_ETH_ALEN);
-
-  if (esp_now_is_peer_exist(mac_addr)) {
-    esp_err_t res = esp_now_del_peer(mac_addr);
-    if (res != ESP_OK) {
-      ESP_LOGE(TAG, "Failed to delete peer");
+  esp_err_t result = ESP_FAIL;
+  if (receiver_lock_channel()) {
+    result = peer_manager_set_peer(mac_addr, channel);
+    // Fresh connection, the receiver may have restarted. Encryption comes back with its capabilities.
+    if (result == ESP_OK) {
+      peer_manager_set_encryption(false);
     }
+    receiver_unlock_channel();
   }
 
-  esp_err_t result = esp_now_add_peer(&peerInfo);
-
   if (result == ESP_OK) {
-    connection_update_state(CONNECTION_STATE_CONNECTING);
+    handle_event(CONNECTION_EVENT_CONNECT);
   }
   else {
     ESP_LOGE(TAG, "Failed to add peer");
@@ -122,15 +187,23 @@ void connection_init() {
     pairing_state = PAIRING_STATE_PAIRED;
   }
 
+  connection_mutex = xSemaphoreCreateMutex();
+  esp_timer_create_args_t timer_args = {
+      .callback = connection_timer_callback, .arg = NULL, .dispatch_method = ESP_TIMER_TASK, .name = "ConnectionTimer"};
+  ESP_ERROR_CHECK(esp_timer_create(&timer_args, &connection_timer));
+  xTaskCreatePinnedToCore(connection_task, "connection_task", 4096, NULL, 20, &connection_task_handle, 0);
+
   // start off in connecting mode
   if (pairing_state == PAIRING_STATE_PAIRED) {
     connection_connect_to_default_peer();
   }
-
-  xTaskCreatePinnedToCore(connection_task, "connection_task", 4096, NULL, 20, &connection_task_handle, 0);
 }
 
 void connection_deinit() {
+  if (connection_timer != NULL) {
+    esp_timer_stop(connection_timer);
+  }
+
   if (connection_task_handle != NULL) {
     vTaskDelete(connection_task_handle);
     connection_task_handle = NULL;
@@ -1,14 +1,8 @@
 #ifndef __CONNECTION_H
 #define __CONNECTION_H
+#include "connection_fsm.h"
 #include <esp_timer.h>
 
-typedef enum {
-  CONNECTION_STATE_DISCONNECTED,
-  CONNECTION_STATE_CONNECTING,
-  CONNECTION_STATE_CONNECTED,
-  CONNECTION_STATE_RECONNECTING
-} ConnectionState;
-
 typedef enum {
   PAIRING_STATE_UNPAIRED,
   PAIRING_STATE_PAIRING,
@@ -19,7 +13,8 @@ typedef enum {
 extern ConnectionState connection_state;
 extern PairingState pairing_state;
 
-void connection_update_state(ConnectionState state);
+void connection_notify_frame();
+void connection_disconnect();
 void connection_init();
 void connection_deinit();
 void connection_connect_to_peer(uint8_t *mac_addr, uint8_t channel);
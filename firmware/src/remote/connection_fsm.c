@@ -0,0 +1,54 @@
+#include "connection_fsm.h"
+
+static ConnectionTransition make_transition(ConnectionState state, uint8_t actions, uint32_t timer_ms) {
+  ConnectionTransition transition = {.state = state, .actions = actions, .timer_ms = timer_ms};
+  return transition;
+}
+
+static ConnectionTransition on_frame(ConnectionState state) {
+  switch (state) {
+  case CONNECTION_STATE_CONNECTING:
+    // First frame from the receiver
+    return make_transition(CONNECTION_STATE_CONNECTED, CONNECTION_ACTION_SAVE_PAIRING, CONNECTION_HEALTH_CHECK_MS);
+  case CONNECTION_STATE_CONNECTED:
+  case CONNECTION_STATE_RECONNECTING:
+    return make_transition(CONNECTION_STATE_CONNECTED, CONNECTION_ACTION_NONE, CONNECTION_HEALTH_CHECK_MS);
+  default:
+    // Late frame after disconnecting
+    return make_transition(CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0);
+  }
+}
+
+static ConnectionTransition on_timeout(ConnectionState state) {
+  if (state == CONNECTION_STATE_CONNECTED) {
+    // Silent while connected. The caller normally turns this into a link health event first.
+    return make_transition(CONNECTION_STATE_RECONNECTING, CONNECTION_ACTION_NONE, CONNECTION_GIVE_UP_TIMEOUT_MS);
+  }
+
+  // Connecting or reconnecting failed
+  return make_transition(CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0);
+}
+
+// Pure function of the current state and event. Applying the returned state, actions and timer is up to the caller.
+ConnectionTransition connection_fsm_transition(ConnectionState state, ConnectionEvent event) {
+  switch (event) {
+  case CONNECTION_EVENT_CONNECT:
+    return make_transition(CONNECTION_STATE_CONNECTING, CONNECTION_ACTION_NONE, CONNECTION_GIVE_UP_TIMEOUT_MS);
+  case CONNECTION_EVENT_DISCONNECT:
+    return make_transition(CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0);
+  case CONNECTION_EVENT_FRAME:
+    return on_frame(state);
+  case CONNECTION_EVENT_TIMEOUT:
+    return on_timeout(state);
+  case CONNECTION_EVENT_LINK_FADE:
+    if (state == CONNECTION_STATE_CONNECTED) {
+      // Stay connected so the UI doesn't flap, check again shortly
+      return make_transition(CONNECTION_STATE_CONNECTED, CONNECTION_ACTION_NONE, CONNECTION_HEALTH_CHECK_MS);
+    }
+    return on_timeout(state);
+  case CONNECTION_EVENT_LINK_LOST:
+    return on_timeout(state);
+  default:
+    return make_transition(state, CONNECTION_ACTION_NONE, 0);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef __CONNECTION_FSM_H
+#define __CONNECTION_FSM_H
+#include <stdint.h>
+
+// Free of ESP-IDF dependencies so the transitions can be exercised off target
+typedef enum {
+  CONNECTION_STATE_DISCONNECTED,
+  CONNECTION_STATE_CONNECTING,
+  CONNECTION_STATE_CONNECTED,
+  CONNECTION_STATE_RECONNECTING
+} ConnectionState;
+
+typedef enum {
+  CONNECTION_EVENT_CONNECT,    // Start connecting to the paired receiver
+  CONNECTION_EVENT_DISCONNECT, // Stop, e.g. pairing, updating or going to sleep
+  CONNECTION_EVENT_FRAME,      // Board data arrived from the active receiver
+  CONNECTION_EVENT_TIMEOUT,    // The connection timer expired
+  CONNECTION_EVENT_LINK_FADE,  // Silent while connected, but likely to recover
+  CONNECTION_EVENT_LINK_LOST,  // Silent while connected and unlikely to recover
+} ConnectionEvent;
+
+typedef enum {
+  CONNECTION_ACTION_NONE = 0,
+  CONNECTION_ACTION_SAVE_PAIRING = 1 << 0, // Remember the receiver and the channel we connected on
+} ConnectionAction;
+
+// Silence while connected after which the link health is checked, and then rechecked
+#define CONNECTION_HEALTH_CHECK_MS 150
+// How long connecting or reconnecting may take before giving up
+#define CONNECTION_GIVE_UP_TIMEOUT_MS 30000
+
+typedef struct {
+  ConnectionState state;
+  uint8_t actions;   // ConnectionAction flags
+  uint32_t timer_ms; // Re-arm the connection timer with this delay, 0 stops it
+} ConnectionTransition;
+
+ConnectionTransition connection_fsm_transition(ConnectionState state, ConnectionEvent event);
+
+#endif
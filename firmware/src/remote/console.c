@@ -2,9 +2,17 @@
 #include "config.h"
 #include "esp_console.h"
 #include "esp_log.h"
+#include "espnow.h"
+#include "group.h"
+#include "link_stats.h"
+#include "peers.h"
 #include "powermanagement.h"
+#include "receiver.h"
 #include "settings.h"
+#include "time.h"
+#include "transmitter.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 // https://github.com/espressif/esp-idf/blob/master/examples/system/console/basic/main/console_example_main.c
@@ -85,6 +93,163 @@ static void register_erase_command() {
   ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
 }
 
+static int get_rx_latency() {
+  ReceiverLatencyStats stats = receiver_get_latency_stats();
+  uint32_t avg_latency_us = stats.frames > 0 ? (uint32_t)(stats.total_latency_us / stats.frames) : 0;
+  printf("frames: %lu\n", stats.frames);
+  printf("idle_wakeups: %lu\n", stats.idle_wakeups);
+  printf("last_latency_us: %lu\n", stats.last_latency_us);
+  printf("avg_latency_us: %lu\n", avg_latency_us);
+  printf("max_latency_us: %lu\n", stats.max_latency_us);
+  return 0;
+}
+
+static void register_rx_latency_command() {
+  esp_console_cmd_t cmd = {
+      .command = "rx_latency",
+      .help = "Get receiver latency counters.\n"
+              "Latency is measured from the ESP-NOW receive callback to processing in the receiver task.",
+      .hint = NULL,
+      .func = &get_rx_latency,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+}
+
+static int get_tx_latency() {
+  TransmitterLatencyStats stats = transmitter_get_latency_stats();
+  uint32_t avg_latency_us = stats.input_frames > 0 ? (uint32_t)(stats.total_latency_us / stats.input_frames) : 0;
+  printf("input_frames: %lu\n", stats.input_frames);
+  printf("keepalive_frames: %lu\n", stats.keepalive_frames);
+  printf("last_latency_us: %lu\n", stats.last_latency_us);
+  printf("avg_latency_us: %lu\n", avg_latency_us);
+  printf("max_latency_us: %lu\n", stats.max_latency_us);
+  printf("keepalive_interval_ms: %lu\n", stats.keepalive_interval_ms);
+  return 0;
+}
+
+static void register_tx_latency_command() {
+  esp_console_cmd_t cmd = {
+      .command = "tx_latency",
+      .help = "Get transmitter latency counters.\n"
+              "Latency is measured from an input change to the frame carrying it being handed to ESP-NOW.",
+      .hint = NULL,
+      .func = &get_tx_latency,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+}
+
+static int get_link_stats() {
+  LinkStats stats = link_stats_get();
+  uint32_t tx_attempts = stats.tx_frames + stats.tx_send_failures;
+  uint32_t rx_expected = stats.rx_sequenced_frames + stats.rx_lost;
+  uint32_t tx_loss = tx_attempts > 0 ? (stats.tx_send_failures + stats.tx_delivery_failures) * 100 / tx_attempts : 0;
+  uint32_t rx_loss = rx_expected > 0 ? stats.rx_lost * 100 / rx_expected : 0;
+  printf("tx_frames: %lu\n", stats.tx_frames);
+  printf("tx_send_failures: %lu\n", stats.tx_send_failures);
+  printf("tx_delivery_failures: %lu\n", stats.tx_delivery_failures);
+  printf("tx_retries: %lu\n", stats.tx_retries);
+  printf("tx_bursts: %lu\n", stats.tx_bursts);
+  printf("tx_burst_copies: %lu\n", stats.tx_burst_copies);
+  printf("tx_burst_saves: %lu\n", stats.tx_burst_saves);
+  printf("tx_loss_pct: %lu\n", tx_loss);
+  printf("rx_frames: %lu\n", stats.rx_frames);
+  printf("rx_sequenced_frames: %lu\n", stats.rx_sequenced_frames);
+  printf("rx_lost: %lu\n", stats.rx_lost);
+  printf("rx_duplicates: %lu\n", stats.rx_duplicates);
+  printf("rx_loss_pct: %lu\n", rx_loss);
+  printf("rx_jitter_us: %lu\n", stats.rx_jitter_us);
+
+  // Buckets are 10 dB wide, see get_rssi_bucket
+  printf("rssi >= -40: %lu\n", stats.rssi_histogram[0]);
+  for (int i = 1; i < LINK_STATS_RSSI_BUCKETS - 1; i++) {
+    printf("rssi %d to %d: %lu\n", -31 - i * 10, -40 - i * 10, stats.rssi_histogram[i]);
+  }
+  printf("rssi < %d: %lu\n", -30 - (LINK_STATS_RSSI_BUCKETS - 1) * 10,
+         stats.rssi_histogram[LINK_STATS_RSSI_BUCKETS - 1]);
+  return 0;
+}
+
+static void register_link_stats_command() {
+  esp_console_cmd_t cmd = {
+      .command = "link_stats",
+      .help = "Get radio link counters.\n"
+              "Includes send failures, retries, sequence loss, jitter and an RSSI histogram.",
+      .hint = NULL,
+      .func = &get_link_stats,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+}
+
+static int get_peers() {
+  SavedPeers peers = peers_get();
+  for (int i = 0; i < peers.deviceCount; i++) {
+    SavedPeer *peer = &peers.devices[i];
+    printf("%d: %s %02X:%02X:%02X:%02X:%02X:%02X channel %d%s\n", i, peer->name, peer->mac[0], peer->mac[1],
+           peer->mac[2], peer->mac[3], peer->mac[4], peer->mac[5], peer->channel,
+           is_same_mac(peer->mac, pairing_settings.remote_addr) ? " (active)" : "");
+  }
+  return 0;
+}
+
+static void register_peers_command() {
+  esp_console_cmd_t cmd = {
+      .command = "peers",
+      .help = "List the paired receivers, most recently used first.",
+      .hint = NULL,
+      .func = &get_peers,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+}
+
+static int get_group() {
+  GroupSlot slots[GROUP_MAX_SLOTS];
+  uint8_t count = group_get_slots(slots);
+  int64_t now = get_current_time_ms();
+
+  printf("group_mode: %s, channel %d\n", group_is_enabled() ? "on" : "off", pairing_settings.channel);
+  for (int i = 0; i < count; i++) {
+    GroupSlot *slot = &slots[i];
+    printf("%02X:%02X:%02X:%02X:%02X:%02X age %lld ms, rssi %d, channel %d%s, speed %.1f, battery %.0f%%, "
+           "state %d, tx %lu, failures %lu, off channel skips %lu\n",
+           slot->mac[0], slot->mac[1], slot->mac[2], slot->mac[3], slot->mac[4], slot->mac[5],
+           now - slot->last_updated, slot->rssi, slot->channel,
+           slot->channel != pairing_settings.channel ? " (not ours)" : "", slot->telemetry.speed,
+           slot->telemetry.battery_level, slot->telemetry.state, slot->tx_frames, slot->delivery_failures,
+           slot->off_channel_skips);
+  }
+  return 0;
+}
+
+static void register_group_command() {
+  esp_console_cmd_t cmd = {
+      .command = "group",
+      .help = "List the boards heard in group mode other than the active one. Boards on another channel are skipped.",
+      .hint = NULL,
+      .func = &get_group,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+}
+
+static int get_rx_drops() {
+  ReceiverDropStats stats = receiver_get_drop_stats();
+  printf("total: %lu\n", stats.total);
+  printf("core_data: %lu\n", stats.core_data);
+  printf("pairing: %lu\n", stats.pairing);
+  printf("version: %lu\n", stats.version);
+  printf("other: %lu\n", stats.other);
+  return 0;
+}
+
+static void register_rx_drops_command() {
+  esp_console_cmd_t cmd = {
+      .command = "rx_drops",
+      .help = "Get the number of received frames dropped because the RX queue was full, by command type",
+      .hint = NULL,
+      .func = &get_rx_drops,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+}
+
 static int get_settings(int argc, char **argv) {
   if (argc > 1) {
     ESP_LOGE(TAG, "Usage: settings");
@@ -104,6 +269,9 @@ static int get_settings(int argc, char **argv) {
     printf("WiFi Credentials:\n");
     printf("wifi_ssid: %s\n", current_ssid);
     printf("wifi_password: %s\n", current_password);
+    printf("Radio:\n");
+    printf("tx_burst: %d\n", device_settings.tx_burst_count);
+    printf("group_mode: %d\n", device_settings.group_mode);
   }
 
   return 0;
@@ -160,6 +328,23 @@ static int save_settings_command(int argc, char **argv) {
           ESP_LOGI(TAG, "Setting Password: %s", value);
         }
       }
+      else if (strcmp(setting, "tx_burst") == 0) {
+        int burst_count = atoi(value);
+        if (burst_count < 1 || burst_count > MAX_TX_BURST_COUNT) {
+          ESP_LOGE(TAG, "tx_burst must be between 1 and %d.", MAX_TX_BURST_COUNT);
+          return -1;
+        }
+        else {
+          ESP_LOGI(TAG, "Saving TX burst count: %d", burst_count);
+          device_settings.tx_burst_count = burst_count;
+          save_device_settings();
+        }
+      }
+      else if (strcmp(setting, "group_mode") == 0) {
+        ESP_LOGI(TAG, "Saving group mode: %d", atoi(value) != 0);
+        device_settings.group_mode = atoi(value) != 0;
+        save_device_settings();
+      }
       else {
         ESP_LOGE(TAG, "Unknown setting: %s", setting);
         return -1;
@@ -196,6 +381,12 @@ void console_init() {
   register_erase_command();
   register_get_settings_command();
   register_save_settings_command();
+  register_rx_latency_command();
+  register_rx_drops_command();
+  register_tx_latency_command();
+  register_link_stats_command();
+  register_peers_command();
+  register_group_command();
 
 #if defined(CONFIG_ESP_CONSOLE_UART_DEFAULT) || defined(CONFIG_ESP_CONSOLE_UART_CUSTOM)
   esp_console_dev_uart_config_t hw_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
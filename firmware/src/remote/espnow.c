@@ -2,6 +2,7 @@
 #include "esp_now.h"
 #include "esp_wifi.h"
 #include "nvs_flash.h"
+#include "peer_manager.h"
 #include "settings.h"
 #include <esp_log.h>
 #include <esp_wifi.h>
@@ -84,6 +85,7 @@ void espnow_init() {
 
 void espnow_deinit() {
   ESP_ERROR_CHECK(esp_now_deinit());
+  peer_manager_reset();
   ESP_ERROR_CHECK(esp_wifi_stop());
   ESP_ERROR_CHECK(esp_wifi_deinit());
   ESP_LOGI(TAG, "ESP-NOW deinitialized");
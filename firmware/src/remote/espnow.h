@@ -11,9 +11,11 @@ bool espnow_is_initialized();
 // Structure to hold ESP-NOW data
 typedef struct {
   uint8_t mac_addr[ESP_NOW_ETH_ALEN];
-  uint8_t *data;
+  uint8_t slot; // Index into the frame pool holding the payload
   int len;
   uint8_t chan;
+  int rssi;
+  int64_t rx_time_us; // Time the frame was handed to us by the WiFi task
 } esp_now_event_t;
 
 bool is_same_mac(const uint8_t *mac1, const uint8_t *mac2);
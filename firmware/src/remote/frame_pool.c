@@ -0,0 +1,63 @@
+#include "frame_pool.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+
+static const char *TAG = "PUBREMOTE-FRAME_POOL";
+
+#if FRAME_POOL_SIZE > 32
+  #error "FRAME_POOL_SIZE must fit in the 32 bit slot mask"
+#endif
+
+#define FRAME_POOL_FULL_MASK ((uint32_t)((1ULL << FRAME_POOL_SIZE) - 1))
+
+// Backing storage is reserved once at startup and never freed
+static uint8_t frame_pool_slots[FRAME_POOL_SIZE][FRAME_POOL_SLOT_SIZE];
+// Bit set = slot in use
+static atomic_uint_fast32_t frame_pool_used = 0;
+
+void frame_pool_init() {
+  atomic_store(&frame_pool_used, 0);
+}
+
+uint8_t frame_pool_acquire() {
+  uint_fast32_t used = atomic_load(&frame_pool_used);
+
+  while (1) {
+    uint32_t free_mask = ~used & FRAME_POOL_FULL_MASK;
+    if (free_mask == 0) {
+      return FRAME_POOL_INVALID_SLOT;
+    }
+
+    uint8_t slot = __builtin_ctz(free_mask);
+    // On failure used is reloaded with the current mask and we retry
+    if (atomic_compare_exchange_weak(&frame_pool_used, &used, used | (1UL << slot))) {
+      return slot;
+    }
+  }
+}
+
+void frame_pool_release(uint8_t slot) {
+  if (slot >= FRAME_POOL_SIZE) {
+    ESP_LOGE(TAG, "Invalid slot release: %d", slot);
+    return;
+  }
+
+  uint32_t bit = 1UL << slot;
+  uint_fast32_t previous = atomic_fetch_and(&frame_pool_used, ~bit);
+
+  if (!(previous & bit)) {
+    ESP_LOGE(TAG, "Double release of slot %d", slot);
+  }
+}
+
+uint8_t *frame_pool_data(uint8_t slot) {
+  if (slot >= FRAME_POOL_SIZE) {
+    return NULL;
+  }
+
+  return frame_pool_slots[slot];
+}
+
+uint8_t frame_pool_in_use() {
+  return __builtin_popcount(atomic_load(&frame_pool_used));
+}
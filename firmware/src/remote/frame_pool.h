@@ -0,0 +1,20 @@
+#ifndef __FRAME_POOL_H
+#define __FRAME_POOL_H
+
+#include <esp_now.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// Fixed pool of ESP-NOW frame buffers shared between the WiFi task (producer) and the receiver task (consumer).
+// Slots are claimed and returned with atomic bit operations so neither side ever takes a lock or touches the heap.
+#define FRAME_POOL_SLOT_SIZE ESP_NOW_MAX_DATA_LEN
+#define FRAME_POOL_SIZE 16
+#define FRAME_POOL_INVALID_SLOT 0xFF
+
+void frame_pool_init();
+uint8_t frame_pool_acquire();
+void frame_pool_release(uint8_t slot);
+uint8_t *frame_pool_data(uint8_t slot);
+uint8_t frame_pool_in_use();
+
+#endif
@@ -0,0 +1,221 @@
+#include "group.h"
+#include "commands.h"
+#include "connection.h"
+#include "esp_log.h"
+#include "espnow.h"
+#include "settings.h"
+#include "time.h"
+#include "utilities/buffer_utils.h"
+#include <freertos/FreeRTOS.h>
+#include <string.h>
+
+static const char *TAG = "PUBREMOTE-GROUP";
+
+#define SECRET_CODE_SIZE 4
+
+static GroupSlot group_slots[GROUP_MAX_SLOTS] = {};
+// Delta frames from each board are applied to that board's own keyframe. Only touched from the receiver task.
+static TelemetryDecoder group_decoders[GROUP_MAX_SLOTS] = {};
+static portMUX_TYPE group_lock = portMUX_INITIALIZER_UNLOCKED;
+
+bool group_is_enabled() {
+  return device_settings.group_mode && pairing_state == PAIRING_STATE_PAIRED;
+}
+
+// Call with group_lock held. Returns the slot for mac_addr or -1
+static int find_slot(const uint8_t *mac_addr) {
+  for (int i = 0; i < GROUP_MAX_SLOTS; i++) {
+    if (group_slots[i].last_updated != 0 && is_same_mac(group_slots[i].mac, mac_addr)) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+// Call with group_lock held. Reuses the slot heard from longest ago when all are taken
+static int claim_slot(const uint8_t *mac_addr) {
+  int oldest = 0;
+  for (int i = 1; i < GROUP_MAX_SLOTS; i++) {
+    if (group_slots[i].last_updated < group_slots[oldest].last_updated) {
+      oldest = i;
+    }
+  }
+
+  memset(&group_slots[oldest], 0, sizeof(GroupSlot));
+  memcpy(group_slots[oldest].mac, mac_addr, ESP_NOW_ETH_ALEN);
+  memset(&group_decoders[oldest], 0, sizeof(TelemetryDecoder));
+  return oldest;
+}
+
+// Board data from a roster receiver other than the active one. Called from the receiver task.
+bool group_process_data(const uint8_t *mac_addr, int rssi, uint8_t channel, const uint8_t *data, int len) {
+  uint8_t command = data[0];
+  if ((command != REM_SET_CORE_DATA && command != REM_SET_TELEMETRY) || len < 1 + SECRET_CODE_SIZE) {
+    return false;
+  }
+
+  SavedPeer peer;
+  int32_t ind = 1;
+  if (!peers_find(mac_addr, &peer) || buffer_get_uint32(data, &ind) != peer.secret_code) {
+    return false;
+  }
+
+  taskENTER_CRITICAL(&group_lock);
+  int slot = find_slot(mac_addr);
+  if (slot < 0) {
+    slot = claim_slot(mac_addr);
+  }
+  // Decoders are only used by this task, so decode outside the lock
+  group_slots[slot].last_updated = get_current_time_ms();
+  taskEXIT_CRITICAL(&group_lock);
+
+  TelemetryData telemetry;
+  bool is_decoded =
+      command == REM_SET_CORE_DATA
+          ? decode_board_data(data + 1, len - 1, &telemetry)
+          : telemetry_decode_peer(&group_decoders[slot], data + 1 + SECRET_CODE_SIZE, len - 1 - SECRET_CODE_SIZE,
+                                  &telemetry) == TELEMETRY_DECODE_OK;
+
+  taskENTER_CRITICAL(&group_lock);
+  group_slots[slot].rssi = rssi;
+  group_slots[slot].channel = channel;
+  if (is_decoded) {
+    group_slots[slot].telemetry = telemetry;
+  }
+  taskEXIT_CRITICAL(&group_lock);
+
+  return is_decoded;
+}
+
+// Channel a member is expected on: the one it was last heard on while it is still talking to us, otherwise the one
+// we last connected to it on. 0 when unknown. Call with group_lock held.
+static uint8_t get_member_channel(const SavedPeer *peer, int64_t now) {
+  int slot = find_slot(peer->mac);
+  if (slot >= 0 && group_slots[slot].channel != 0 && now - group_slots[slot].last_updated < GROUP_MEMBER_TIMEOUT_MS) {
+    return group_slots[slot].channel;
+  }
+
+  return peer->channel;
+}
+
+// Sends the input state to every roster receiver other than the active one, back to back on the current channel.
+// Members known to be on another channel are skipped rather than sent frames they can never hear.
+// Called from the transmitter task with the channel lock held.
+void group_send_input_state(const RemoteData *data) {
+  // Only touched from the transmitter task
+  static uint8_t last_off_channel_count = 0;
+
+  uint8_t frame[1 + SECRET_CODE_SIZE + sizeof(RemoteData)];
+  frame[0] = REM_SET_INPUT_STATE;
+  memcpy(frame + 1 + SECRET_CODE_SIZE, data, sizeof(RemoteData));
+
+  int64_t now = get_current_time_ms();
+  uint8_t off_channel_count = 0;
+  SavedPeers peers = peers_get();
+  for (int i = 0; i < peers.deviceCount; i++) {
+    SavedPeer *peer = &peers.devices[i];
+    if (is_same_mac(peer->mac, pairing_settings.remote_addr)) {
+      continue;
+    }
+
+    taskENTER_CRITICAL(&group_lock);
+    uint8_t member_channel = get_member_channel(peer, now);
+    bool is_off_channel = member_channel != 0 && member_channel != pairing_settings.channel;
+    if (is_off_channel) {
+      int slot = find_slot(peer->mac);
+      if (slot >= 0) {
+        group_slots[slot].off_channel_skips++;
+      }
+    }
+    taskEXIT_CRITICAL(&group_lock);
+
+    if (is_off_channel) {
+      ESP_LOGD(TAG, "Skipping %s on channel %d", peer->name, member_channel);
+      off_channel_count++;
+      continue;
+    }
+
+    // Receivers only accept frames carrying their own secret code. Capabilities are only known for the active
+    // receiver, so group members always get the legacy frame.
+    memcpy(frame + 1, &peer->secret_code, SECRET_CODE_SIZE);
+
+    esp_err_t result = esp_now_send(peer->mac, frame, sizeof(frame));
+    if (result == ESP_ERR_ESPNOW_NOT_FOUND) {
+      // Channel 0 follows the current channel, so members never need updating on a hop
+      esp_now_peer_info_t peer_info = {};
+      peer_info.channel = 0;
+      peer_info.encrypt = false;
+      memcpy(peer_info.peer_addr, peer->mac, ESP_NOW_ETH_ALEN);
+      if (esp_now_add_peer(&peer_info) == ESP_OK) {
+        result = esp_now_send(peer->mac, frame, sizeof(frame));
+      }
+    }
+
+    if (result != ESP_OK) {
+      ESP_LOGD(TAG, "Failed to send to %s: %s", peer->name, esp_err_to_name(result));
+      continue;
+    }
+
+    taskENTER_CRITICAL(&group_lock);
+    int slot = find_slot(peer->mac);
+    if (slot >= 0) {
+      group_slots[slot].tx_frames++;
+    }
+    taskEXIT_CRITICAL(&group_lock);
+  }
+
+  // Warn on changes only, this runs at the transmit rate
+  if (off_channel_count != last_off_channel_count) {
+    if (off_channel_count > 0) {
+      ESP_LOGW(TAG, "%d group member(s) not on channel %d, skipping them", off_channel_count,
+               pairing_settings.channel);
+    }
+    last_off_channel_count = off_channel_count;
+  }
+}
+
+// Called from the send callback in WiFi task context
+void group_record_delivery(const uint8_t *mac_addr, bool is_delivered) {
+  if (is_delivered) {
+    return;
+  }
+
+  taskENTER_CRITICAL(&group_lock);
+  int slot = find_slot(mac_addr);
+  if (slot >= 0) {
+    group_slots[slot].delivery_failures++;
+  }
+  taskEXIT_CRITICAL(&group_lock);
+}
+
+// Copies the slots in use, returns how many
+uint8_t group_get_slots(GroupSlot *slots) {
+  uint8_t count = 0;
+
+  taskENTER_CRITICAL(&group_lock);
+  for (int i = 0; i < GROUP_MAX_SLOTS; i++) {
+    if (group_slots[i].last_updated != 0) {
+      slots[count++] = group_slots[i];
+    }
+  }
+  taskEXIT_CRITICAL(&group_lock);
+
+  return count;
+}
+
+// Members other than the active receiver heard from recently
+uint8_t group_get_member_count() {
+  uint8_t count = 0;
+  int64_t now = get_current_time_ms();
+
+  taskENTER_CRITICAL(&group_lock);
+  for (int i = 0; i < GROUP_MAX_SLOTS; i++) {
+    if (group_slots[i].last_updated != 0 && now - group_slots[i].last_updated < GROUP_MEMBER_TIMEOUT_MS) {
+      count++;
+    }
+  }
+  taskEXIT_CRITICAL(&group_lock);
+
+  return count;
+}
\ No newline at end of file
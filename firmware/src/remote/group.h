@@ -0,0 +1,39 @@
+#ifndef __GROUP_H
+#define __GROUP_H
+#include "peers.h"
+#include "remoteinputs.h"
+#include "telemetry.h"
+#include <esp_now.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// Group mode drives every receiver in the peer roster at once. The active receiver keeps feeding the stats pipeline
+// and the UI, every other receiver only updates its own telemetry slot, so extra boards cost a copy each and no
+// redraws.
+//
+// The remote only ever listens and transmits on the active receiver's channel, it never hops per member. Members
+// that were last heard on, or last connected on, another channel are skipped until they show up on ours, so a group
+// only works when every board sits on the same channel.
+#define GROUP_MAX_SLOTS MAX_SAVED_PEERS
+// Members not heard from for this long no longer count towards the boards shown on the stats screen
+#define GROUP_MEMBER_TIMEOUT_MS 1000
+
+typedef struct {
+  uint8_t mac[ESP_NOW_ETH_ALEN];
+  int64_t last_updated; // 0 if the slot is free
+  int8_t rssi;
+  uint8_t channel; // Channel the board was last heard on
+  uint32_t tx_frames;
+  uint32_t off_channel_skips; // Input frames not sent because the board is on another channel
+  uint32_t delivery_failures;
+  TelemetryData telemetry;
+} GroupSlot;
+
+bool group_is_enabled();
+bool group_process_data(const uint8_t *mac_addr, int rssi, uint8_t channel, const uint8_t *data, int len);
+void group_send_input_state(const RemoteData *data);
+void group_record_delivery(const uint8_t *mac_addr, bool is_delivered);
+uint8_t group_get_slots(GroupSlot *slots);
+uint8_t group_get_member_count();
+
+#endif
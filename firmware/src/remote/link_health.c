@@ -0,0 +1,105 @@
+#include "link_health.h"
+#include <freertos/FreeRTOS.h>
+
+// Frame interval assumed until enough frames were seen
+#define DEFAULT_INTERVAL_US 50000
+#define MIN_INTERVAL_US 20000
+#define MAX_INTERVAL_US 500000
+// Silence up to this many expected intervals is normal jitter
+#define GOOD_INTERVALS 2
+// Silence beyond this many intervals with a weak or failing link is a loss
+#define LOST_INTERVALS 4
+#define MIN_LOST_SILENCE_US 200000
+// Silence beyond this is a loss however healthy the link looked
+#define MAX_FADE_US 1000000
+// Weak signal, or signal falling this fast, makes a silence more likely to be a loss
+#define WEAK_RSSI -85
+#define FALLING_RSSI_TREND -6
+#define FAILING_TX_STREAK 3
+
+typedef struct {
+  int64_t last_rx_us; // 0 before the first frame
+  int32_t interval_us;
+  int16_t rssi_fast; // dBm * 16 so the averages keep their fractions
+  int16_t rssi_slow;
+  uint8_t tx_failure_streak;
+} LinkHealthState;
+
+static LinkHealthState health = {.interval_us = DEFAULT_INTERVAL_US};
+static portMUX_TYPE health_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void link_health_reset() {
+  taskENTER_CRITICAL(&health_lock);
+  health = (LinkHealthState){.interval_us = DEFAULT_INTERVAL_US};
+  taskEXIT_CRITICAL(&health_lock);
+}
+
+// Receiver task, every frame from the active receiver
+void link_health_record_rx(int rssi, int64_t rx_time_us) {
+  taskENTER_CRITICAL(&health_lock);
+  if (health.last_rx_us == 0) {
+    health.rssi_fast = rssi * 16;
+    health.rssi_slow = rssi * 16;
+  }
+  else {
+    int32_t interval_us = rx_time_us - health.last_rx_us;
+    if (interval_us > MAX_INTERVAL_US) {
+      interval_us = MAX_INTERVAL_US;
+    }
+    // Average of the last ~8 intervals and the last ~2 and ~16 RSSI readings
+    health.interval_us += (interval_us - health.interval_us) / 8;
+    health.rssi_fast += (rssi * 16 - health.rssi_fast) / 2;
+    health.rssi_slow += (rssi * 16 - health.rssi_slow) / 16;
+  }
+  health.last_rx_us = rx_time_us;
+  taskEXIT_CRITICAL(&health_lock);
+}
+
+// WiFi task, delivery result of every frame sent to the active receiver
+void link_health_record_tx(bool is_delivered) {
+  taskENTER_CRITICAL(&health_lock);
+  if (is_delivered) {
+    health.tx_failure_streak = 0;
+  }
+  else if (health.tx_failure_streak < UINT8_MAX) {
+    health.tx_failure_streak++;
+  }
+  taskEXIT_CRITICAL(&health_lock);
+}
+
+LinkHealth link_health_assess(int64_t now_us) {
+  taskENTER_CRITICAL(&health_lock);
+  LinkHealthState state = health;
+  taskEXIT_CRITICAL(&health_lock);
+
+  if (state.last_rx_us == 0) {
+    return LINK_HEALTH_LOST;
+  }
+
+  int32_t expected_us = state.interval_us;
+  if (expected_us < MIN_INTERVAL_US) {
+    expected_us = MIN_INTERVAL_US;
+  }
+
+  int64_t silence_us = now_us - state.last_rx_us;
+  if (silence_us <= (int64_t)expected_us * GOOD_INTERVALS) {
+    return LINK_HEALTH_GOOD;
+  }
+
+  if (silence_us >= MAX_FADE_US) {
+    return LINK_HEALTH_LOST;
+  }
+
+  bool is_weak = state.rssi_fast < WEAK_RSSI * 16 || state.rssi_fast - state.rssi_slow <= FALLING_RSSI_TREND * 16;
+  bool is_tx_failing = state.tx_failure_streak >= FAILING_TX_STREAK;
+  int64_t lost_silence_us = (int64_t)expected_us * LOST_INTERVALS;
+  if (lost_silence_us < MIN_LOST_SILENCE_US) {
+    lost_silence_us = MIN_LOST_SILENCE_US;
+  }
+
+  if (silence_us >= lost_silence_us && (is_weak || is_tx_failing)) {
+    return LINK_HEALTH_LOST;
+  }
+
+  return LINK_HEALTH_FADE;
+}
\ No newline at end of file
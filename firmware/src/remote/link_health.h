@@ -0,0 +1,19 @@
+#ifndef __LINK_HEALTH_H
+#define __LINK_HEALTH_H
+#include <stdbool.h>
+#include <stdint.h>
+
+// Tells a short fade, which usually recovers within a few hundred ms, from a link that is gone. Built from frame
+// inter-arrival times, the RSSI trend and delivery failures of our own frames.
+typedef enum {
+  LINK_HEALTH_GOOD,
+  LINK_HEALTH_FADE, // Silent for longer than usual, keep waiting
+  LINK_HEALTH_LOST, // Start looking for the receiver
+} LinkHealth;
+
+void link_health_reset();
+void link_health_record_rx(int rssi, int64_t rx_time_us);
+void link_health_record_tx(bool is_delivered);
+LinkHealth link_health_assess(int64_t now_us);
+
+#endif
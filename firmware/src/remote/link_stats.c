@@ -0,0 +1,166 @@
+#include "link_stats.h"
+#include "stats.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+// Counters have a single writer each: tx from the transmitter task, delivery failures from the WiFi task and rx from
+// the receiver task. Readers may see a slightly stale set, which is fine for statistics.
+static LinkStats link_stats = {0};
+
+// After this long without a sequenced frame the 8 bit counter may have moved anywhere, including into the half that
+// looks like a duplicate, so the next frame is taken as the new baseline
+#define LINK_STATS_RESYNC_US 500000
+
+// Set by other tasks, the receiver task applies the reset before it records the next frame
+static atomic_bool is_rx_reset_pending = false;
+
+// Receiver task state
+static bool has_rx_sequence = false;
+static uint8_t last_rx_sequence = 0;
+static int64_t last_rx_sequence_time_us = 0;
+static int64_t last_rx_time_us = 0;
+static int64_t last_rx_interval_us = 0;
+static uint32_t rx_window_start_frames = 0;
+static uint32_t rx_window_start_lost = 0;
+
+// Transmitter task state
+static uint32_t tx_window_start_frames = 0;
+static uint32_t tx_window_start_failures = 0;
+
+static uint8_t get_rssi_bucket(int rssi) {
+  int bucket = (-40 - rssi + 9) / 10;
+
+  if (bucket < 0) {
+    return 0;
+  }
+  else if (bucket >= LINK_STATS_RSSI_BUCKETS) {
+    return LINK_STATS_RSSI_BUCKETS - 1;
+  }
+
+  return bucket;
+}
+
+void link_stats_record_tx() {
+  link_stats.tx_frames++;
+
+  uint32_t frames = link_stats.tx_frames - tx_window_start_frames;
+  if (frames < LINK_STATS_WINDOW) {
+    return;
+  }
+
+  uint32_t failures = link_stats.tx_delivery_failures - tx_window_start_failures;
+  uint8_t loss = failures >= frames ? 100 : failures * 100 / frames;
+
+  RemoteStats *stats = stats_begin_update();
+  stats->txPacketLoss = loss;
+  stats_publish();
+
+  tx_window_start_frames = link_stats.tx_frames;
+  tx_window_start_failures = link_stats.tx_delivery_failures;
+}
+
+void link_stats_record_tx_send_failure() {
+  link_stats.tx_send_failures++;
+}
+
+// Called from the WiFi task
+void link_stats_record_tx_delivery_failure() {
+  link_stats.tx_delivery_failures++;
+}
+
+void link_stats_record_tx_retry() {
+  link_stats.tx_retries++;
+}
+
+static void apply_pending_rx_reset() {
+  if (!atomic_exchange(&is_rx_reset_pending, false)) {
+    return;
+  }
+
+  has_rx_sequence = false;
+  last_rx_time_us = 0;
+  last_rx_interval_us = 0;
+  rx_window_start_frames = link_stats.rx_sequenced_frames;
+  rx_window_start_lost = link_stats.rx_lost;
+}
+
+void link_stats_record_rx(int rssi, int64_t rx_time_us) {
+  apply_pending_rx_reset();
+  link_stats.rx_frames++;
+  link_stats.rssi_histogram[get_rssi_bucket(rssi)]++;
+
+  if (last_rx_time_us > 0) {
+    int64_t interval_us = rx_time_us - last_rx_time_us;
+
+    if (last_rx_interval_us > 0) {
+      // RFC 3550 style estimator over the change in inter-arrival time
+      int64_t deviation = llabs(interval_us - last_rx_interval_us);
+      link_stats.rx_jitter_us += (int32_t)((deviation - (int64_t)link_stats.rx_jitter_us) / 16);
+    }
+
+    last_rx_interval_us = interval_us;
+  }
+
+  last_rx_time_us = rx_time_us;
+}
+
+void link_stats_record_tx_burst(uint8_t copies_sent, bool saved) {
+  link_stats.tx_bursts++;
+  link_stats.tx_burst_copies += copies_sent - 1;
+  if (saved) {
+    link_stats.tx_burst_saves++;
+  }
+}
+
+// Returns false for duplicate or stale frames, which should be dropped
+bool link_stats_record_rx_sequence(uint8_t sequence) {
+  apply_pending_rx_reset();
+  link_stats.rx_sequenced_frames++;
+
+  if (has_rx_sequence) {
+    uint8_t gap = (uint8_t)(sequence - last_rx_sequence - 1);
+    // link_stats_record_rx runs first, so last_rx_time_us is the arrival time of this frame
+    bool is_resync = last_rx_time_us - last_rx_sequence_time_us > LINK_STATS_RESYNC_US;
+
+    if (!is_resync && (sequence == last_rx_sequence || gap >= UINT8_MAX / 2)) {
+      // Duplicate or reordered frame, keep the newest sequence
+      link_stats.rx_duplicates++;
+      return false;
+    }
+
+    // A gap that looks backwards after a resync is a receiver restart or a wrap, not loss we can count
+    if (gap < UINT8_MAX / 2) {
+      link_stats.rx_lost += gap;
+    }
+  }
+
+  has_rx_sequence = true;
+  last_rx_sequence = sequence;
+  last_rx_sequence_time_us = last_rx_time_us;
+
+  uint32_t received = link_stats.rx_sequenced_frames - rx_window_start_frames;
+  uint32_t lost = link_stats.rx_lost - rx_window_start_lost;
+  uint32_t expected = received + lost;
+  if (expected < LINK_STATS_WINDOW) {
+    return true;
+  }
+
+  RemoteStats *stats = stats_begin_update();
+  stats->rxPacketLoss = lost * 100 / expected;
+  stats_publish();
+
+  rx_window_start_frames = link_stats.rx_sequenced_frames;
+  rx_window_start_lost = link_stats.rx_lost;
+  return true;
+}
+
+// Forget the previous receiver sequence so the first frame of a new connection starts a fresh baseline instead of
+// counting the counter difference across the outage as loss. Called from the connection task and on pairing, the
+// receiver task owns the sequence state and applies the reset on its next frame.
+void link_stats_reset_rx_sequence() {
+  atomic_store(&is_rx_reset_pending, true);
+}
+
+LinkStats link_stats_get() {
+  return link_stats;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef __LINK_STATS_H
+#define __LINK_STATS_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// 10 dB wide buckets, from >= -40 dBm down to < -100 dBm
+#define LINK_STATS_RSSI_BUCKETS 8
+// Loss percentages in RemoteStats are recalculated every this many frames
+#define LINK_STATS_WINDOW 32
+
+typedef struct {
+  // Transmit side
+  uint32_t tx_frames;            // Frames accepted by esp_now_send
+  uint32_t tx_send_failures;     // Frames rejected by esp_now_send
+  uint32_t tx_delivery_failures; // Frames the peer did not acknowledge
+  uint32_t tx_retries;           // Frames sent to recover from a delivery failure
+  uint32_t tx_bursts;            // Critical transitions sent as a burst
+  uint32_t tx_burst_copies;      // Extra copies sent beyond the first frame of a burst
+  uint32_t tx_burst_saves;       // Bursts acknowledged after a copy was reported lost
+  // Receive side
+  uint32_t rx_frames;
+  uint32_t rx_sequenced_frames;
+  uint32_t rx_lost;       // Gaps in the receiver sequence
+  uint32_t rx_duplicates; // Repeated or out of order sequence numbers
+  uint32_t rx_jitter_us;  // Smoothed inter-arrival jitter
+  uint32_t rssi_histogram[LINK_STATS_RSSI_BUCKETS];
+} LinkStats;
+
+void link_stats_record_tx();
+void link_stats_record_tx_send_failure();
+void link_stats_record_tx_delivery_failure();
+void link_stats_record_tx_retry();
+void link_stats_record_rx(int rssi, int64_t rx_time_us);
+bool link_stats_record_rx_sequence(uint8_t sequence);
+void link_stats_reset_rx_sequence();
+void link_stats_record_tx_burst(uint8_t copies_sent, bool saved);
+LinkStats link_stats_get();
+
+#endif
@@ -3,7 +3,10 @@
 #include "connection.h"
 #include "esp_log.h"
 #include "espnow.h"
+#include "peer_manager.h"
+#include "peers.h"
 #include "settings.h"
+#include "utilities/buffer_utils.h"
 #include <esp_now.h>
 #include <ui/ui.h>
 
@@ -25,24 +28,12 @@ bool pairing_process_init_event(uint8_t *data, int len, esp_now_event_t evt) {
     //          mac_addr[3], mac_addr[4], mac_addr[5]);
     uint8_t PAIR_BOND_RES[2] = {REM_PAIR_BOND};
     // Do this internally as we don't want it to change connection state
-    esp_now_peer_info_t peerInfo = {};
-    peerInfo.channel = evt.chan; // Set the channel number (0-14)
-    peerInfo.encrypt = false;
-    memcpy(peerInfo.peer_addr, pairing_settings.remote_addr, sizeof(pairing_settings.remote_addr));
     pairing_settings.channel = evt.chan;
-    // ESP_ERROR_CHECK(esp_now_add_peer(&peerInfo));
     uint8_t *mac_addr = pairing_settings.remote_addr;
     esp_err_t result = ESP_FAIL;
 
     if (receiver_lock_channel()) {
-      if (esp_now_is_peer_exist(mac_addr)) {
-        esp_err_t res = esp_now_del_peer(mac_addr);
-        if (res != ESP_OK) {
-          ESP_LOGE(TAG, "Failed to delete peer");
-        }
-      }
-
-      esp_now_add_peer(&peerInfo);
+      peer_manager_set_peer(mac_addr, evt.chan);
 
       result = esp_now_send(mac_addr, (uint8_t *)&PAIR_BOND_RES, sizeof(PAIR_BOND_RES));
       receiver_unlock_channel();
@@ -71,7 +62,8 @@ bool pairing_process_bond_event(uint8_t *data, int len) {
     // grab secret code
     ESP_LOGI(TAG, "Grabbing secret code");
     ESP_LOGI(TAG, "packet Length: %d", len);
-    pairing_settings.secret_code = (int32_t)(data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+    int32_t ind = 0;
+    pairing_settings.secret_code = buffer_get_int32(data, &ind);
     ESP_LOGI(TAG, "Secret Code: %li", pairing_settings.secret_code);
     char *formattedString;
     asprintf(&formattedString, "%ld", pairing_settings.secret_code);
@@ -100,6 +92,7 @@ bool pairing_process_completion_event(uint8_t *data, int len) {
       if (LVGL_lock(0)) {
         pairing_state = PAIRING_STATE_PAIRED;
         save_pairing_data();
+        peers_save_active();
         connection_connect_to_default_peer();
         lv_disp_load_scr(ui_StatsScreen);
         LVGL_unlock();
@@ -0,0 +1,134 @@
+#include "peer_manager.h"
+#include "esp_log.h"
+#include "esp_now.h"
+#include "session_key.h"
+#include "settings.h"
+#include <string.h>
+
+static const char *TAG = "PUBREMOTE-PEER_MANAGER";
+
+// Mirror of the entry in the ESP-NOW peer table
+static esp_now_peer_info_t cached_peer = {};
+static bool has_cached_peer = false;
+// Derived once per receiver and secret code so enabling encryption costs no key derivation
+static uint8_t session_key[ESP_NOW_KEY_LEN];
+static uint32_t session_key_secret = 0;
+static bool has_session_key = false;
+
+static bool prepare_session_key() {
+  if (pairing_settings.secret_code == DEFAULT_PAIRING_SECRET_CODE) {
+    return false;
+  }
+
+  if (has_session_key && session_key_secret == pairing_settings.secret_code) {
+    return true;
+  }
+
+  has_session_key = session_key_derive(pairing_settings.secret_code, cached_peer.peer_addr, session_key) == ESP_OK;
+  session_key_secret = pairing_settings.secret_code;
+  return has_session_key;
+}
+
+static esp_err_t set_channel(uint8_t channel) {
+  if (!has_cached_peer) {
+    return ESP_ERR_ESPNOW_NOT_FOUND;
+  }
+
+  if (cached_peer.channel == channel) {
+    return ESP_OK;
+  }
+
+  esp_now_peer_info_t peer_info = cached_peer;
+  peer_info.channel = channel;
+
+  esp_err_t result = esp_now_mod_peer(&peer_info);
+  if (result != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to update peer channel: %s", esp_err_to_name(result));
+    return result;
+  }
+
+  cached_peer = peer_info;
+  return ESP_OK;
+}
+
+esp_err_t peer_manager_set_peer(const uint8_t *mac_addr, uint8_t channel) {
+  if (has_cached_peer && memcmp(cached_peer.peer_addr, mac_addr, ESP_NOW_ETH_ALEN) == 0) {
+    return set_channel(channel);
+  }
+
+  // Only a new receiver needs the table entry replaced
+  if (has_cached_peer && esp_now_is_peer_exist(cached_peer.peer_addr)) {
+    esp_err_t res = esp_now_del_peer(cached_peer.peer_addr);
+    if (res != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to delete peer: %s", esp_err_to_name(res));
+    }
+  }
+  has_cached_peer = false;
+
+  esp_now_peer_info_t peer_info = {};
+  peer_info.channel = channel;
+  peer_info.encrypt = false;
+  memcpy(peer_info.peer_addr, mac_addr, ESP_NOW_ETH_ALEN);
+
+  // The entry may be left over from before the cache was reset
+  esp_err_t result = esp_now_is_peer_exist(mac_addr) ? esp_now_mod_peer(&peer_info) : esp_now_add_peer(&peer_info);
+  if (result != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to add peer: %s", esp_err_to_name(result));
+    return result;
+  }
+
+  cached_peer = peer_info;
+  has_cached_peer = true;
+  // New receiver, derive its key now rather than when it asks for encryption
+  has_session_key = false;
+  prepare_session_key();
+  return ESP_OK;
+}
+
+// Switches the active peer between plain and encrypted frames, keeping its channel
+esp_err_t peer_manager_set_encryption(bool is_enabled) {
+  if (!has_cached_peer) {
+    return ESP_ERR_ESPNOW_NOT_FOUND;
+  }
+
+  if (cached_peer.encrypt == is_enabled) {
+    return ESP_OK;
+  }
+
+  if (is_enabled && !prepare_session_key()) {
+    return ESP_FAIL;
+  }
+
+  esp_now_peer_info_t peer_info = cached_peer;
+  peer_info.encrypt = is_enabled;
+  if (is_enabled) {
+    memcpy(peer_info.lmk, session_key, ESP_NOW_KEY_LEN);
+  }
+  else {
+    memset(peer_info.lmk, 0, ESP_NOW_KEY_LEN);
+  }
+
+  esp_err_t result = esp_now_mod_peer(&peer_info);
+  if (result != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to update peer encryption: %s", esp_err_to_name(result));
+    return result;
+  }
+
+  ESP_LOGI(TAG, "Peer encryption %s", is_enabled ? "enabled" : "disabled");
+  cached_peer = peer_info;
+  return ESP_OK;
+}
+
+bool peer_manager_is_encrypted() {
+  return has_cached_peer && cached_peer.encrypt;
+}
+
+// 0 if there is no peer
+uint8_t peer_manager_get_channel() {
+  return has_cached_peer ? cached_peer.channel : 0;
+}
+
+// The peer table is cleared when ESP-NOW is deinitialized
+void peer_manager_reset() {
+  has_cached_peer = false;
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef __PEER_MANAGER_H
+#define __PEER_MANAGER_H
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// Keeps the ESP-NOW peer table entry for the paired receiver and a cached copy of its info. Channel changes are
+// applied in place with esp_now_mod_peer rather than deleting and re-adding the peer. A new peer always starts
+// unencrypted, encryption is switched on once the receiver advertises it.
+// Callers hold the receiver channel lock.
+esp_err_t peer_manager_set_peer(const uint8_t *mac_addr, uint8_t channel);
+esp_err_t peer_manager_set_encryption(bool is_enabled);
+bool peer_manager_is_encrypted();
+uint8_t peer_manager_get_channel();
+void peer_manager_reset();
+
+#endif
@@ -0,0 +1,165 @@
+#include "peers.h"
+#include "connection.h"
+#include "esp_log.h"
+#include "espnow.h"
+#include "link_stats.h"
+#include "receiver.h"
+#include "settings.h"
+#include "telemetry.h"
+#include <freertos/FreeRTOS.h>
+#include <string.h>
+
+static const char *TAG = "PUBREMOTE-PEERS";
+
+#define SAVED_PEERS_KEY "saved_peers"
+// Open addressing index from MAC to roster position, kept at most half full
+#define PEER_INDEX_SIZE 16
+#define PEER_INDEX_EMPTY 0xFF
+
+static SavedPeers saved_peers = {};
+static uint8_t peer_index[PEER_INDEX_SIZE];
+static portMUX_TYPE peers_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// The vendor half of the MAC is shared by every board, so hash the device half
+static uint8_t get_mac_hash(const uint8_t *mac_addr) {
+  return (mac_addr[3] * 31 + mac_addr[4] * 7 + mac_addr[5]) & (PEER_INDEX_SIZE - 1);
+}
+
+// Call with peers_lock held
+static void rebuild_index() {
+  memset(peer_index, PEER_INDEX_EMPTY, sizeof(peer_index));
+
+  for (uint8_t i = 0; i < saved_peers.deviceCount; i++) {
+    uint8_t slot = get_mac_hash(saved_peers.devices[i].mac);
+    while (peer_index[slot] != PEER_INDEX_EMPTY) {
+      slot = (slot + 1) & (PEER_INDEX_SIZE - 1);
+    }
+    peer_index[slot] = i;
+  }
+}
+
+// Call with peers_lock held. Returns the roster position or -1
+static int find_peer(const uint8_t *mac_addr) {
+  uint8_t slot = get_mac_hash(mac_addr);
+
+  for (int probe = 0; probe < PEER_INDEX_SIZE && peer_index[slot] != PEER_INDEX_EMPTY; probe++) {
+    uint8_t position = peer_index[slot];
+    if (is_same_mac(saved_peers.devices[position].mac, mac_addr)) {
+      return position;
+    }
+    slot = (slot + 1) & (PEER_INDEX_SIZE - 1);
+  }
+
+  return -1;
+}
+
+static void save_peers() {
+  SavedPeers snapshot;
+  taskENTER_CRITICAL(&peers_lock);
+  snapshot = saved_peers;
+  taskEXIT_CRITICAL(&peers_lock);
+
+  if (nvs_write_blob(SAVED_PEERS_KEY, &snapshot, sizeof(snapshot)) != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to save peers");
+  }
+}
+
+void peers_init() {
+  SavedPeers loaded;
+  if (nvs_read_blob(SAVED_PEERS_KEY, &loaded, sizeof(loaded)) != ESP_OK || loaded.deviceCount > MAX_SAVED_PEERS) {
+    memset(&loaded, 0, sizeof(loaded));
+  }
+
+  taskENTER_CRITICAL(&peers_lock);
+  saved_peers = loaded;
+  rebuild_index();
+  taskEXIT_CRITICAL(&peers_lock);
+
+  // Carry over the receiver paired before the roster existed
+  if (pairing_settings.secret_code != DEFAULT_PAIRING_SECRET_CODE) {
+    peers_save_active();
+  }
+}
+
+// Add or refresh the active receiver and move it to the front
+void peers_save_active() {
+  bool has_changed = true;
+  // Default name for a new entry, built here since formatting is too slow for the critical section
+  char default_name[SAVED_PEER_NAME_SIZE];
+  snprintf(default_name, sizeof(default_name), "Board %02X%02X", pairing_settings.remote_addr[4],
+           pairing_settings.remote_addr[5]);
+
+  taskENTER_CRITICAL(&peers_lock);
+  int position = find_peer(pairing_settings.remote_addr);
+  SavedPeer peer = {};
+
+  if (position >= 0) {
+    peer = saved_peers.devices[position];
+    has_changed = position != 0 || peer.channel != pairing_settings.channel ||
+                  peer.secret_code != pairing_settings.secret_code;
+  }
+  else {
+    memcpy(peer.mac, pairing_settings.remote_addr, ESP_NOW_ETH_ALEN);
+    memcpy(peer.name, default_name, sizeof(peer.name));
+    // Drop the least recently used receiver when full
+    position = saved_peers.deviceCount < MAX_SAVED_PEERS ? saved_peers.deviceCount++ : MAX_SAVED_PEERS - 1;
+  }
+
+  peer.channel = pairing_settings.channel;
+  peer.secret_code = pairing_settings.secret_code;
+  memmove(&saved_peers.devices[1], &saved_peers.devices[0], position * sizeof(SavedPeer));
+  saved_peers.devices[0] = peer;
+  rebuild_index();
+  taskEXIT_CRITICAL(&peers_lock);
+
+  // Avoid flash writes on every reconnect to the same receiver
+  if (has_changed) {
+    save_peers();
+  }
+}
+
+bool peers_find(const uint8_t *mac_addr, SavedPeer *peer) {
+  taskENTER_CRITICAL(&peers_lock);
+  int position = find_peer(mac_addr);
+  if (position >= 0) {
+    *peer = saved_peers.devices[position];
+  }
+  taskEXIT_CRITICAL(&peers_lock);
+
+  return position >= 0;
+}
+
+// Make a known receiver the active one if it proved itself with its secret code
+bool peers_try_switch(const uint8_t *mac_addr, uint32_t secret_code, uint8_t channel) {
+  SavedPeer peer;
+  if (!peers_find(mac_addr, &peer) || peer.secret_code != secret_code) {
+    return false;
+  }
+
+  ESP_LOGI(TAG, "Switching to %s on channel %d", peer.name, channel);
+  // The transmitter reads the active receiver under the channel lock
+  if (!receiver_lock_channel()) {
+    return false;
+  }
+  memcpy(pairing_settings.remote_addr, peer.mac, ESP_NOW_ETH_ALEN);
+  pairing_settings.secret_code = peer.secret_code;
+  pairing_settings.channel = channel;
+  receiver_unlock_channel();
+
+  // Sequence and keyframe belong to the previous board
+  link_stats_reset_rx_sequence();
+  telemetry_reset();
+
+  save_pairing_data();
+  peers_save_active();
+  connection_connect_to_peer(pairing_settings.remote_addr, channel);
+  return true;
+}
+
+SavedPeers peers_get() {
+  SavedPeers snapshot;
+  taskENTER_CRITICAL(&peers_lock);
+  snapshot = saved_peers;
+  taskEXIT_CRITICAL(&peers_lock);
+  return snapshot;
+}
\ No newline at end of file
@@ -1,15 +1,28 @@
 #ifndef __PEERS_H
 #define __PEERS_H
+#include <esp_now.h>
+#include <stdbool.h>
 #include <stdio.h>
 
+#define MAX_SAVED_PEERS 8
+#define SAVED_PEER_NAME_SIZE 32
+
 typedef struct {
-  uint8_t mac[6];  // MAC address storage
-  char name[32];   // Device name (adjust size as needed)
-  uint8_t channel; // Device channel
+  uint8_t mac[ESP_NOW_ETH_ALEN];    // MAC address storage
+  char name[SAVED_PEER_NAME_SIZE]; // Device name
+  uint8_t channel;                 // Last channel we connected on
+  uint32_t secret_code;            // Secret code from pairing
 } SavedPeer;
 
+// Most recently used first, persisted in NVS
 typedef struct {
   uint8_t deviceCount;
-  SavedPeer *devices;
+  SavedPeer devices[MAX_SAVED_PEERS];
 } SavedPeers;
-#endif
\ No newline at end of file
+
+void peers_init();
+void peers_save_active();
+bool peers_find(const uint8_t *mac_addr, SavedPeer *peer);
+bool peers_try_switch(const uint8_t *mac_addr, uint32_t secret_code, uint8_t channel);
+SavedPeers peers_get();
+#endif
@@ -53,11 +53,16 @@ static void IRAM_ATTR pmu_isr_handler(void *arg) {
 
 static void power_state_update() {
   RemotePowerState powerState = get_power_state();
-  remoteStats.remoteBatteryVoltage = powerState.voltage;
-  remoteStats.remoteBatteryPercentage = battery_mv_to_percent(remoteStats.remoteBatteryVoltage);
-  remoteStats.chargeState = powerState.chargeState;
-  remoteStats.chargeCurrent = powerState.current;
-  ESP_LOGD(TAG, "Battery volts: %u %d", remoteStats.remoteBatteryVoltage, remoteStats.remoteBatteryPercentage);
+  uint8_t battery_percentage = battery_mv_to_percent(powerState.voltage);
+
+  RemoteStats *stats = stats_begin_update();
+  stats->remoteBatteryVoltage = powerState.voltage;
+  stats->remoteBatteryPercentage = battery_percentage;
+  stats->chargeState = powerState.chargeState;
+  stats->chargeCurrent = powerState.current;
+  stats_publish();
+
+  ESP_LOGD(TAG, "Battery volts: %u %d", powerState.voltage, battery_percentage);
   is_power_connected = powerState.isPowered;
 }
 
@@ -97,7 +102,9 @@ static esp_err_t enable_wake() {
 }
 
 static bool power_button_long_press_hold() {
-  BoardState state = remoteStats.state;
+  RemoteStats stats;
+  stats_read_snapshot(&stats);
+  BoardState state = stats.state;
   if (state == BOARD_STATE_RUNNING || state == BOARD_STATE_RUNNING_FLYWHEEL || state == BOARD_STATE_RUNNING_TILTBACK ||
       state == BOARD_STATE_RUNNING_UPSIDEDOWN || state == BOARD_STATE_RUNNING_WHEELSLIP) {
     ESP_LOGI(TAG, "Power button long press hold detected. Ignoring.");
@@ -206,7 +213,7 @@ void enter_sleep() {
 
 static void enter_sleep_internal() {
   // Disable some things so they don't run during wake check
-  connection_update_state(CONNECTION_STATE_DISCONNECTED);
+  connection_disconnect();
   unbind_power_button();
 
   // Turn off screen before sleep
@@ -335,8 +342,10 @@ void power_management_task(void *pvParameters) {
       last_time = current_time;
     }
 
-    if (remoteStats.remoteBatteryVoltage < MIN_BATTERY_VOLTAGE && !is_power_connected) {
-      ESP_LOGW(TAG, "Battery voltage too low: %d mV", remoteStats.remoteBatteryVoltage);
+    RemoteStats stats;
+    stats_read_snapshot(&stats);
+    if (stats.remoteBatteryVoltage < MIN_BATTERY_VOLTAGE && !is_power_connected) {
+      ESP_LOGW(TAG, "Battery voltage too low: %d mV", stats.remoteBatteryVoltage);
       buzzer_set_tone(NOTE_ERROR, ERROR_NOTE_DURATION);
       vTaskDelay(pdMS_TO_TICKS(ERROR_NOTE_DURATION)); // Allow time for the note to play
 
@@ -345,8 +354,8 @@ void power_management_task(void *pvParameters) {
     }
 
     // Todo - Check battery voltage and enter sleep if too low
-    // if (remoteStats.remoteBatteryVoltage <= MIN_BATTERY_VOLTAGE && !is_power_connected) {
-    //   ESP_LOGW(TAG, "Battery voltage too low: %d mV", remoteStats.remoteBatteryVoltage);
+    // if (stats.remoteBatteryVoltage <= MIN_BATTERY_VOLTAGE && !is_power_connected) {
+    //   ESP_LOGW(TAG, "Battery voltage too low: %d mV", stats.remoteBatteryVoltage);
     //   play_note(NOTE_ERROR, 1000);
     //   // If battery is too low, enter sleep immediately
     //   enter_sleep_internal();
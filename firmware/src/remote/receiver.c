@@ -1,4 +1,5 @@
 #include "receiver.h"
+#include "channel_planner.h"
 #include "commands.h"
 #include "connection.h"
 #include "display.h"
@@ -7,12 +8,20 @@
 #include "esp_timer.h"
 #include "esp_wifi.h"
 #include "espnow.h"
+#include "frame_pool.h"
+#include "group.h"
+#include "link_health.h"
+#include "link_stats.h"
 #include "pairing.h"
+#include "peer_manager.h"
 #include "peers.h"
 #include "powermanagement.h"
 #include "screens/pairing_screen.h"
 #include "stats.h"
+#include "telemetry.h"
+#include "transmitter.h"
 #include "time.h"
+#include "utilities/buffer_utils.h"
 #include "utilities/conversion_utils.h"
 #include <freertos/queue.h>
 #include <math.h>
@@ -26,94 +35,273 @@ static const char *TAG = "PUBREMOTE-RECEIVER";
 
 static TaskHandle_t receiver_task_handle = NULL;
 static QueueHandle_t espnow_queue;
+static ReceiverLatencyStats latency_stats = {0};
+static ReceiverDropStats drop_stats = {0};
+
+static void release_event(esp_now_event_t *evt) {
+  frame_pool_release(evt->slot);
+  evt->slot = FRAME_POOL_INVALID_SLOT;
+}
+
+static void count_drop(uint8_t command) {
+  drop_stats.total++;
+
+  switch (command) {
+  case REM_SET_CORE_DATA:
+  case REM_SET_TELEMETRY:
+    drop_stats.core_data++;
+    break;
+  case REM_PAIR_INIT:
+  case REM_PAIR_BOND:
+  case REM_PAIR_COMPLETE:
+    drop_stats.pairing++;
+    break;
+  case REM_VERSION:
+  case REM_RECEIVER_VERSION:
+    drop_stats.version++;
+    break;
+  default:
+    drop_stats.other++;
+    break;
+  }
+}
 
 static void on_data_recv(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len) {
   // This callback runs in WiFi task context!
   ESP_LOGD(TAG, "RECEIVED");
+  if (len <= 0 || len > FRAME_POOL_SLOT_SIZE) {
+    ESP_LOGE(TAG, "Invalid frame length: %d", len);
+    return;
+  }
+
   esp_now_event_t evt;
+  evt.slot = frame_pool_acquire();
+  if (evt.slot == FRAME_POOL_INVALID_SLOT) {
+    ESP_LOGW(TAG, "Frame pool exhausted, dropping frame");
+    count_drop(data[0]);
+    return;
+  }
+
   memcpy(evt.mac_addr, recv_info->src_addr, ESP_NOW_ETH_ALEN);
-  evt.data = malloc(len);
-  memcpy(evt.data, data, len);
+  memcpy(frame_pool_data(evt.slot), data, len);
   evt.len = len;
   evt.chan = recv_info->rx_ctrl->channel;
-  remoteStats.signalStrength = recv_info->rx_ctrl->rssi;
+  evt.rssi = recv_info->rx_ctrl->rssi;
+  evt.rx_time_us = esp_timer_get_time();
 
-#if RX_QUEUE_SIZE > 1
-  // Send to queue for processing in application task
+  // Bounded ring with drop-oldest semantics. Evict the oldest frame to make room so bursts keep the newest data
   if (uxQueueSpacesAvailable(espnow_queue) == 0) {
-    // reset the queue
-    xQueueReset(espnow_queue);
-  }
-  if (xQueueSend(espnow_queue, &evt, portMAX_DELAY) != pdTRUE) {
-#else
-  // overwrite the previous data
-  if (xQueueOverwrite(espnow_queue, &evt) != pdTRUE) {
-#endif
+    esp_now_event_t stale_evt;
+    if (xQueueReceive(espnow_queue, &stale_evt, 0) == pdTRUE) {
+      count_drop(frame_pool_data(stale_evt.slot)[0]);
+      release_event(&stale_evt);
+    }
+  }
+
+  // Never block the WiFi task. The receiver task is the only other party touching the queue and only ever takes from it
+  if (xQueueSend(espnow_queue, &evt, 0) != pdTRUE) {
     ESP_LOGE(TAG, "Queue send failed");
-    free(evt.data);
+    count_drop(data[0]);
+    release_event(&evt);
   }
 }
 
+// Handlers receive the payload following the command byte, already validated against their descriptor
+typedef void (*command_handler_t)(uint8_t *data, int len, esp_now_event_t *evt);
+
+typedef struct {
+  command_handler_t handler;
+  // Accepted payload length range, excluding the command byte
+  uint8_t min_len;
+  uint8_t max_len;
+  // Pairing commands are only accepted on the pairing screen in the given pairing state
+  bool requires_pairing_screen;
+  PairingState pairing_state;
+} CommandDescriptor;
+
+#define COMMAND_MAX_PAYLOAD_LEN (ESP_NOW_MAX_DATA_LEN - 1)
+
+static void handle_version(uint8_t *data, int len, esp_now_event_t *evt) {
+  ESP_LOGI(TAG, "Rec: Version: %d", data[1]);
+  // TODO - send back receiver version
+}
+
+static void handle_receiver_version(uint8_t *data, int len, esp_now_event_t *evt) {
+  ESP_LOGI(TAG, "Rec: Receiver version: %d", data[1]);
+}
+
+// [capabilities u8][secret code i32]. The secret code keeps a spoofed MAC from changing capabilities, and a
+// capability frame can only ever turn encryption on, see transmitter_set_receiver_capabilities
+static void handle_receiver_capabilities(uint8_t *data, int len, esp_now_event_t *evt) {
+  int32_t ind = 1;
+  if (pairing_state != PAIRING_STATE_PAIRED || buffer_get_int32(data, &ind) != pairing_settings.secret_code) {
+    ESP_LOGW(TAG, "Rec: Ignoring receiver capabilities without our secret code");
+    return;
+  }
+
+  transmitter_set_receiver_capabilities(data[0]);
+}
+
+static void handle_pair_init(uint8_t *data, int len, esp_now_event_t *evt) {
+  ESP_LOGI(TAG, "Process: Pairing init");
+  pairing_process_init_event(data, len, *evt);
+}
+
+static void handle_pair_bond(uint8_t *data, int len, esp_now_event_t *evt) {
+  ESP_LOGI(TAG, "Process: Pairing bond");
+  pairing_process_bond_event(data, len);
+}
+
+static void handle_pair_complete(uint8_t *data, int len, esp_now_event_t *evt) {
+  ESP_LOGI(TAG, "Process: Pairing complete");
+  pairing_process_completion_event(data, len);
+}
+
+static void handle_core_data(uint8_t *data, int len, esp_now_event_t *evt) {
+  ESP_LOGD(TAG, "Rec: Set data");
+  process_board_data(data, len);
+}
+
+static void handle_telemetry(uint8_t *data, int len, esp_now_event_t *evt) {
+  ESP_LOGD(TAG, "Rec: Set telemetry");
+  process_telemetry_data(data, len);
+}
+
+// Indexed directly by command byte, entries without a handler are unknown commands
+static const CommandDescriptor command_table[UINT8_MAX + 1] = {
+    [REM_VERSION] =
+        {
+            .handler = handle_version,
+            .min_len = 2,
+            .max_len = COMMAND_MAX_PAYLOAD_LEN,
+        },
+    [REM_RECEIVER_VERSION] =
+        {
+            .handler = handle_receiver_version,
+            .min_len = 2,
+            .max_len = COMMAND_MAX_PAYLOAD_LEN,
+        },
+    [REM_RECEIVER_CAPABILITIES] =
+        {
+            .handler = handle_receiver_capabilities,
+            .min_len = 5,
+            .max_len = COMMAND_MAX_PAYLOAD_LEN,
+        },
+    [REM_PAIR_INIT] =
+        {
+            .handler = handle_pair_init,
+            .min_len = ESP_NOW_ETH_ALEN,
+            .max_len = ESP_NOW_ETH_ALEN,
+            .requires_pairing_screen = true,
+            .pairing_state = PAIRING_STATE_UNPAIRED,
+        },
+    [REM_PAIR_BOND] =
+        {
+            .handler = handle_pair_bond,
+            .min_len = 4,
+            .max_len = 4,
+            .requires_pairing_screen = true,
+            .pairing_state = PAIRING_STATE_PAIRING,
+        },
+    [REM_PAIR_COMPLETE] =
+        {
+            .handler = handle_pair_complete,
+            .min_len = 1,
+            .max_len = 1,
+            .requires_pairing_screen = true,
+            .pairing_state = PAIRING_STATE_PENDING,
+        },
+    [REM_SET_CORE_DATA] =
+        {
+            .handler = handle_core_data,
+            .min_len = 32,
+            .max_len = 32,
+        },
+    [REM_SET_TELEMETRY] =
+        {
+            .handler = handle_telemetry,
+            .min_len = 4 + TELEMETRY_HEADER_SIZE,
+            .max_len = COMMAND_MAX_PAYLOAD_LEN,
+        },
+};
+
+// While we are looking for the active board, take over any board from the roster that sends us board data. Never
+// while disconnected on purpose (user disconnect, update, sleep) or while the active board is still connected.
+static bool try_switch_board(const uint8_t *data, int len, const esp_now_event_t *evt) {
+  bool is_searching =
+      connection_state == CONNECTION_STATE_CONNECTING || connection_state == CONNECTION_STATE_RECONNECTING;
+  if (pairing_state != PAIRING_STATE_PAIRED || !is_searching) {
+    return false;
+  }
+
+  // Board data starts with the secret code
+  if (len < 1 + 4 || (data[0] != REM_SET_CORE_DATA && data[0] != REM_SET_TELEMETRY)) {
+    return false;
+  }
+
+  int32_t ind = 1;
+  return peers_try_switch(evt->mac_addr, buffer_get_uint32(data, &ind), evt->chan);
+}
+
 static void process_data(esp_now_event_t evt) {
-  uint8_t *data = evt.data;
+  uint8_t *data = frame_pool_data(evt.slot);
   int len = evt.len;
 
+  if (data == NULL || len <= 0 || len > FRAME_POOL_SLOT_SIZE) {
+    ESP_LOGE(TAG, "Invalid frame: slot %d, length %d", evt.slot, len);
+    return;
+  }
+
   bool is_pairing_start = pairing_state == PAIRING_STATE_UNPAIRED && is_pairing_screen_active();
   // Check mac for security on anything other than initial pairing
   if (!is_same_mac(evt.mac_addr, pairing_settings.remote_addr) && !is_pairing_start) {
-    ESP_LOGD(TAG, "Ignoring data from unknown MAC");
-    return;
+    // Other boards in the group only fill their own slot and never reach the stats pipeline
+    if (group_is_enabled()) {
+      group_process_data(evt.mac_addr, evt.rssi, evt.chan, data, len);
+      return;
+    }
+
+    if (!try_switch_board(data, len, &evt)) {
+      ESP_LOGD(TAG, "Ignoring data from unknown MAC");
+      return;
+    }
   }
 
-  RemoteCommands command = (RemoteCommands)data[0];
+  RemoteStats *stats = stats_begin_update();
+  stats->signalStrength = evt.rssi;
+  stats_publish();
+  link_stats_record_rx(evt.rssi, evt.rx_time_us);
+  link_health_record_rx(evt.rssi, evt.rx_time_us);
+
+  uint8_t command = data[0];
   len -= 1; // Remove command byte from length
-  if (len < 0) {
-    ESP_LOGE(TAG, "Invalid data length: %d", len);
-    return;
-  }
 
   data += 1; // Move data pointer to the actual data
 
   ESP_LOGD(TAG, "Command: %d", command);
 
-  switch (command) {
-  case REM_VERSION:
-    ESP_LOGI(TAG, "Rec: Version: %d", data[1]);
-    // TODO - send back receiver version
-    break;
-  case REM_RECEIVER_VERSION:
-    ESP_LOGI(TAG, "Rec: Receiver version: %d", data[1]);
-    break;
-  case REM_PAIR_INIT:
-    if (is_pairing_start) {
-      ESP_LOGI(TAG, "Process: Pairing init");
-      pairing_process_init_event(data, len, evt);
-    }
-    break;
-  case REM_PAIR_BOND:
-    if (pairing_state == PAIRING_STATE_PAIRING && is_pairing_screen_active()) {
-      ESP_LOGI(TAG, "Process: Pairing bond");
-      pairing_process_bond_event(data, len);
-    }
-    break;
-  case REM_PAIR_COMPLETE:
-    if (pairing_state == PAIRING_STATE_PENDING && is_pairing_screen_active()) {
-      ESP_LOGI(TAG, "Process: Pairing complete");
-      pairing_process_completion_event(data, len);
-    }
-    break;
-  case REM_SET_CORE_DATA:
-    ESP_LOGD(TAG, "Rec: Set data");
-    process_board_data(data, len);
-    break;
-  default:
+  const CommandDescriptor *descriptor = &command_table[command];
+
+  if (descriptor->handler == NULL) {
     ESP_LOGE(TAG, "Unknown command: %d", command);
-    break;
+    return;
+  }
+
+  if (len < descriptor->min_len || len > descriptor->max_len) {
+    ESP_LOGE(TAG, "Invalid length for command %d: %d", command, len);
+    return;
+  }
+
+  if (descriptor->requires_pairing_screen &&
+      (pairing_state != descriptor->pairing_state || !is_pairing_screen_active())) {
+    ESP_LOGD(TAG, "Ignoring command %d outside of pairing", command);
+    return;
   }
+
+  descriptor->handler(data, len, &evt);
 }
 
 #define CHANNEL_HOP_INTERVAL_MS 200
-#define RECEIVER_TASK_DELAY_MS 5
 
 // Mutex to protect channel switching
 static SemaphoreHandle_t channel_mutex;
@@ -142,60 +330,74 @@ static void change_channel(uint8_t chan, bool is_pairing) {
 
   if (!is_pairing) {
     // Add peer so we can send if we're already paired
-    uint8_t *mac_addr = pairing_settings.remote_addr;
-
-    if (esp_now_is_peer_exist(mac_addr)) {
-      esp_now_del_peer(mac_addr);
-    }
-
-    esp_now_peer_info_t peerInfo = {};
-    peerInfo.channel = chan;
-    peerInfo.encrypt = false;
-    memcpy(peerInfo.peer_addr, mac_addr, ESP_NOW_ETH_ALEN);
-    esp_now_add_peer(&peerInfo);
+    peer_manager_set_peer(pairing_settings.remote_addr, chan);
   }
 
   receiver_unlock_channel();
 }
 
 static void receiver_task(void *pvParameters) {
+  frame_pool_init();
   espnow_queue = xQueueCreate(RX_QUEUE_SIZE, sizeof(esp_now_event_t));
   ESP_ERROR_CHECK(esp_now_register_recv_cb(on_data_recv));
   ESP_LOGI(TAG, "Registered RX callback");
   esp_now_event_t evt;
   // Hop through channels if in pairing mode or connecting
-  uint64_t channel_switch_time_ms = 0;
+  int64_t next_hop_time_ms = 0;
+  bool was_hopping = false;
+  channel_planner_init();
 
   while (1) {
-    if (xQueueReceive(espnow_queue, &evt, 0) == pdTRUE) {
+    bool is_pairing = pairing_state == PAIRING_STATE_UNPAIRED && is_pairing_screen_active();
+    // Reconnecting probes channels too, starting with the one we lost the receiver on
+    bool is_connecting =
+        connection_state == CONNECTION_STATE_CONNECTING || connection_state == CONNECTION_STATE_RECONNECTING;
+    bool is_hopping = is_connecting || is_pairing;
+
+    if (is_hopping && !was_hopping) {
+      // New search - start from the channel we're on, which is the last good one when reconnecting
+      channel_planner_start(pairing_settings.channel, connection_state == CONNECTION_STATE_RECONNECTING);
+    }
+    was_hopping = is_hopping;
+
+    // Block until a frame arrives. While hopping, wake in time for the next hop, otherwise only often enough to
+    // notice that hopping has started
+    TickType_t wait_ticks = pdMS_TO_TICKS(CHANNEL_HOP_INTERVAL_MS);
+    if (is_hopping) {
+      int64_t now = get_current_time_ms();
+      if (next_hop_time_ms == 0) {
+        next_hop_time_ms = now + channel_planner_get_dwell_ms();
+      }
+      wait_ticks = next_hop_time_ms > now ? pdMS_TO_TICKS(next_hop_time_ms - now) : 0;
+    }
+    else {
+      // reset channel switch time
+      next_hop_time_ms = 0;
+    }
+
+    if (xQueueReceive(espnow_queue, &evt, wait_ticks) == pdTRUE) {
+      uint32_t latency_us = (uint32_t)(esp_timer_get_time() - evt.rx_time_us);
+      latency_stats.frames++;
+      latency_stats.last_latency_us = latency_us;
+      latency_stats.total_latency_us += latency_us;
+      if (latency_us > latency_stats.max_latency_us) {
+        latency_stats.max_latency_us = latency_us;
+      }
+
       process_data(evt);
-      free(evt.data);
+      release_event(&evt);
       // reset channel switch time
-      channel_switch_time_ms = 0;
+      next_hop_time_ms = 0;
     }
     else {
-      bool is_pairing = pairing_state == PAIRING_STATE_UNPAIRED && is_pairing_screen_active();
-      bool is_connecting = connection_state == CONNECTION_STATE_CONNECTING;
+      latency_stats.idle_wakeups++;
+
       // Nothing received while connecting or pairing - hop through channels
-      if (is_connecting || is_pairing) {
-        if (channel_switch_time_ms > CHANNEL_HOP_INTERVAL_MS) {
-// Hop to next channel
-#define NUM_AVAIL_WIFI_CHANNELS 14
-
-          uint8_t next_channel = (pairing_settings.channel % NUM_AVAIL_WIFI_CHANNELS) + 1;
-          change_channel(next_channel, is_pairing);
-          channel_switch_time_ms = 0;
-        }
-        else {
-          channel_switch_time_ms += RECEIVER_TASK_DELAY_MS;
-        }
-      }
-      else {
-        // reset channel switch time
-        channel_switch_time_ms = 0;
+      if (is_hopping && get_current_time_ms() >= next_hop_time_ms) {
+        change_channel(channel_planner_next(), is_pairing);
+        next_hop_time_ms = get_current_time_ms() + channel_planner_get_dwell_ms();
       }
     }
-    vTaskDelay(pdMS_TO_TICKS(RECEIVER_TASK_DELAY_MS));
   }
 
   // The task will not reach this point as it runs indefinitely
@@ -218,4 +420,12 @@ void receiver_deinit() {
     vQueueDelete(espnow_queue);
     espnow_queue = NULL;
   }
+}
+
+ReceiverLatencyStats receiver_get_latency_stats() {
+  return latency_stats;
+}
+
+ReceiverDropStats receiver_get_drop_stats() {
+  return drop_stats;
 }
\ No newline at end of file
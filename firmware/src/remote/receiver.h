@@ -30,9 +30,31 @@ typedef enum {
   BOARD_STATE_DISABLED = 15,
 } BoardState;
 
+typedef struct {
+  // Frames processed
+  uint32_t frames;
+  // Queue waits that timed out without a frame
+  uint32_t idle_wakeups;
+  // Time from the WiFi callback to processing in the receiver task
+  uint32_t last_latency_us;
+  uint32_t max_latency_us;
+  uint64_t total_latency_us;
+} ReceiverLatencyStats;
+
+typedef struct {
+  // Frames evicted from the RX queue or dropped on arrival, by command type
+  uint32_t total;
+  uint32_t core_data;
+  uint32_t pairing;
+  uint32_t version;
+  uint32_t other;
+} ReceiverDropStats;
+
 bool receiver_lock_channel();
 void receiver_unlock_channel();
 void receiver_init();
 void receiver_deinit();
+ReceiverLatencyStats receiver_get_latency_stats();
+ReceiverDropStats receiver_get_drop_stats();
 
 #endif
\ No newline at end of file
@@ -12,6 +12,8 @@
 #include "rom/gpio.h"
 #include "settings.h"
 #include "time.h"
+#include "transmitter.h"
+#include "utilities/input_filter.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
 #include <freertos/task.h>
@@ -51,7 +53,8 @@ float convert_adc_to_axis(int adc_value, int min_val, int mid_val, int max_val,
   // Apply expo
   if (expo > 1) {
     bool negative = axis < 0;
-    axis = pow(axis, expo);
+    // pow of a negative base is NaN for fractional exponents
+    axis = pow(fabsf(axis), expo);
     if (negative) {
       axis = -axis;
     }
@@ -71,6 +74,149 @@ float convert_adc_to_axis(int adc_value, int min_val, int mid_val, int max_val,
   return invert ? -axis : axis;
 }
 
+static int8_t pack_axis(float axis) {
+  float scaled = roundf(axis * 100);
+
+  // A degenerate calibration can divide by zero, send centre rather than an undefined cast
+  if (isnan(scaled)) {
+    return 0;
+  }
+  else if (scaled > 100) {
+    return 100;
+  }
+  else if (scaled < -100) {
+    return -100;
+  }
+
+  // Also folds -0.0 into 0
+  return (int8_t)scaled;
+}
+
+// Only the Y axis can be inverted from the settings
+AxisCalibration get_x_axis_calibration() {
+  AxisCalibration calibration = {
+      .min_val = calibration_settings.x_min,
+      .mid_val = calibration_settings.x_center,
+      .max_val = calibration_settings.x_max,
+      .deadband = calibration_settings.deadband,
+      .expo = calibration_settings.expo,
+      .invert = false,
+  };
+  return calibration;
+}
+
+AxisCalibration get_y_axis_calibration() {
+  AxisCalibration calibration = {
+      .min_val = calibration_settings.y_min,
+      .mid_val = calibration_settings.y_center,
+      .max_val = calibration_settings.y_max,
+      .deadband = calibration_settings.deadband,
+      .expo = calibration_settings.expo,
+      .invert = calibration_settings.invert_y,
+  };
+  return calibration;
+}
+
+static bool is_same_calibration(const AxisCalibration *a, const AxisCalibration *b) {
+  return a->min_val == b->min_val && a->mid_val == b->mid_val && a->max_val == b->max_val &&
+         a->deadband == b->deadband && a->expo == b->expo && a->invert == b->invert;
+}
+
+// Rebuilds the table only when the calibration changed, so it can be called every input cycle
+void axis_lut_update(AxisLut *lut, const AxisCalibration *calibration) {
+  if (lut->is_built && is_same_calibration(&lut->calibration, calibration)) {
+    return;
+  }
+
+  for (int adc_value = 0; adc_value <= STICK_MAX_VAL; adc_value++) {
+    float axis = convert_adc_to_axis(adc_value, calibration->min_val, calibration->mid_val, calibration->max_val,
+                                     calibration->deadband, calibration->expo, calibration->invert);
+    lut->table[adc_value] = pack_axis(axis);
+  }
+
+  lut->calibration = *calibration;
+  lut->is_built = true;
+}
+
+static int clamp_adc_value(int adc_value) {
+  if (adc_value < 0) {
+    return 0;
+  }
+  else if (adc_value > STICK_MAX_VAL) {
+    return STICK_MAX_VAL;
+  }
+
+  return adc_value;
+}
+
+float axis_lut_convert(const AxisLut *lut, int adc_value) {
+  return lut->table[clamp_adc_value(adc_value)] / 100.0f;
+}
+
+// Keeps current while a code within STICK_HYSTERESIS of adc_value still converts to it. The table is monotonic, so that
+// is the case when current lies between the values at both ends of the window.
+float axis_lut_convert_held(const AxisLut *lut, int adc_value, float current) {
+  int8_t held = pack_axis(current);
+  int8_t low = lut->table[clamp_adc_value(adc_value - STICK_HYSTERESIS)];
+  int8_t high = lut->table[clamp_adc_value(adc_value + STICK_HYSTERESIS)];
+
+  if ((low <= held && held <= high) || (high <= held && held <= low)) {
+    return current;
+  }
+
+  return axis_lut_convert(lut, adc_value);
+}
+
+PackedRemoteData pack_remote_data(const RemoteData *data) {
+  PackedRemoteData packed = {
+      .js_y = pack_axis(data->js_y),
+      .js_x = pack_axis(data->js_x),
+      .buttons = 0,
+  };
+
+  if (data->bt_c) {
+    packed.buttons |= PACKED_BUTTON_C;
+  }
+  if (data->bt_z) {
+    packed.buttons |= PACKED_BUTTON_Z;
+  }
+  if (data->is_rev) {
+    packed.buttons |= PACKED_REVERSE;
+  }
+
+  return packed;
+}
+
+#if STICK_OVERSAMPLE_COUNT < 1 || STICK_OVERSAMPLE_COUNT > MEDIAN_MAX_SAMPLES
+  #error "STICK_OVERSAMPLE_COUNT must be between 1 and MEDIAN_MAX_SAMPLES"
+#endif
+
+#if (JOYSTICK_Y_ENABLED || JOYSTICK_X_ENABLED)
+// Back to back oneshot reads, then the median so a single noisy conversion can't move the stick
+static esp_err_t read_axis(adc_oneshot_unit_handle_t handle, adc_channel_t channel, uint16_t *value) {
+  uint16_t samples[STICK_OVERSAMPLE_COUNT];
+
+  for (int i = 0; i < STICK_OVERSAMPLE_COUNT; i++) {
+    int sample;
+    esp_err_t err = adc_oneshot_read(handle, channel, &sample);
+    if (err != ESP_OK) {
+      return err;
+    }
+    samples[i] = sample;
+  }
+
+  *value = median_u16(samples, STICK_OVERSAMPLE_COUNT);
+  return ESP_OK;
+}
+#endif
+
+#if JOYSTICK_X_ENABLED
+static AxisLut x_lut;
+#endif
+#if JOYSTICK_Y_ENABLED
+static AxisLut y_lut;
+#endif
+
 static void thumbstick_task(void *pvParameters) {
 #if (JOYSTICK_Y_ENABLED || JOYSTICK_X_ENABLED)
   #if JOYSTICK_X_ENABLED
@@ -82,6 +228,8 @@ static void thumbstick_task(void *pvParameters) {
       #error "Invalid ADC unit"
     #endif
   ESP_ERROR_CHECK(adc_oneshot_config_channel(x_adc_handle, JOYSTICK_X_ADC, &adc_channel_config));
+  IirFilter x_filter;
+  iir_filter_init(&x_filter, STICK_FILTER_SHIFT);
   #endif
 
   #if JOYSTICK_Y_ENABLED
@@ -94,6 +242,8 @@ static void thumbstick_task(void *pvParameters) {
     #endif
 
   ESP_ERROR_CHECK(adc_oneshot_config_channel(y_adc_handle, JOYSTICK_Y_ADC, &adc_channel_config));
+  IirFilter y_filter;
+  iir_filter_init(&y_filter, STICK_FILTER_SHIFT);
   #endif
 
 #endif
@@ -101,28 +251,24 @@ static void thumbstick_task(void *pvParameters) {
   while (1) {
     uint64_t newTime = get_current_time_ms();
     bool trigger_sleep_disrupt = false;
-    int16_t deadband = calibration_settings.deadband;
-#if JOYSTICK_Y_ENABLED
-    int16_t y_center = calibration_settings.y_center;
-    int16_t y_max = calibration_settings.y_max;
-    int16_t y_min = calibration_settings.y_min;
-#endif
 #if JOYSTICK_X_ENABLED
-    int16_t x_center = calibration_settings.x_center;
-    int16_t x_max = calibration_settings.x_max;
-    int16_t x_min = calibration_settings.y_min;
+    AxisCalibration x_calibration = get_x_axis_calibration();
+    axis_lut_update(&x_lut, &x_calibration);
+#endif
+#if JOYSTICK_Y_ENABLED
+    AxisCalibration y_calibration = get_y_axis_calibration();
+    axis_lut_update(&y_lut, &y_calibration);
 #endif
-    float expo = calibration_settings.expo;
-    bool invert_y = calibration_settings.invert_y;
     esp_err_t read_err;
 #if JOYSTICK_X_ENABLED
-    int x_value;
-    read_err = adc_oneshot_read(x_adc_handle, JOYSTICK_X_ADC, &x_value);
+    uint16_t x_value;
+    read_err = read_axis(x_adc_handle, JOYSTICK_X_ADC, &x_value);
 
     if (read_err == ESP_OK) {
+      x_value = iir_filter_update(&x_filter, x_value);
       joystick_data.x = x_value;
-      float new_x = convert_adc_to_axis(x_value, x_min, x_center, x_max, deadband, expo, false);
       float curr_x = remote_data.js_x;
+      float new_x = axis_lut_convert_held(&x_lut, x_value, curr_x);
 
       if (new_x != curr_x) {
         remote_data.js_x = new_x;
@@ -136,14 +282,14 @@ static void thumbstick_task(void *pvParameters) {
 #endif
 
 #if JOYSTICK_Y_ENABLED
-    int y_value;
-    read_err = adc_oneshot_read(y_adc_handle, JOYSTICK_Y_ADC, &y_value);
+    uint16_t y_value;
+    read_err = read_axis(y_adc_handle, JOYSTICK_Y_ADC, &y_value);
 
     if (read_err == ESP_OK) {
-
+      y_value = iir_filter_update(&y_filter, y_value);
       joystick_data.y = y_value;
-      float new_y = convert_adc_to_axis(y_value, y_min, y_center, y_max, deadband, expo, invert_y);
       float curr_y = remote_data.js_y;
+      float new_y = axis_lut_convert_held(&y_lut, y_value, curr_y);
 
       if (new_y != curr_y) {
         remote_data.js_y = new_y;
@@ -157,6 +303,7 @@ static void thumbstick_task(void *pvParameters) {
 #endif
 
     if (trigger_sleep_disrupt) {
+      transmitter_notify_input_changed();
       reset_sleep_timer();
     }
 
@@ -201,6 +348,7 @@ static void button_down_cb(void *arg, void *usr_data) {
 
   if (!handled) {
     remote_data.bt_c = 1;
+    transmitter_notify_input_changed();
   }
 }
 
@@ -214,6 +362,7 @@ static void button_up_cb(void *arg, void *usr_data) {
 
   if (!handled) {
     remote_data.bt_c = 0;
+    transmitter_notify_input_changed();
   }
 }
 
@@ -30,11 +30,42 @@ typedef struct {
   bool is_rev;
 } RemoteData;
 
+// REM_SET_INPUT_STATE_PACKED payload, sent after the secret code and followed by a sequence byte.
+// Axes are already rounded to 2 decimals so scaling by 100 is lossless.
+typedef struct {
+  int8_t js_y; // -100 to 100
+  int8_t js_x; // -100 to 100
+  uint8_t buttons;
+} PackedRemoteData;
+
+typedef enum {
+  PACKED_BUTTON_C = 1 << 0,
+  PACKED_BUTTON_Z = 1 << 1,
+  PACKED_REVERSE = 1 << 2,
+} PackedButtonFlags;
+
 typedef struct {
   uint16_t x;
   uint16_t y;
 } JoystickData;
 
+// Calibration of one axis, the inputs of convert_adc_to_axis
+typedef struct {
+  int min_val;
+  int mid_val;
+  int max_val;
+  int deadband;
+  float expo;
+  bool invert;
+} AxisCalibration;
+
+// convert_adc_to_axis precomputed for every ADC code, stored as axis * 100 which is exact after its rounding
+typedef struct {
+  AxisCalibration calibration;
+  bool is_built;
+  int8_t table[STICK_MAX_VAL + 1];
+} AxisLut;
+
 extern RemoteData remote_data;
 extern JoystickData joystick_data;
 
@@ -44,5 +75,11 @@ void buttons_deinit();
 void register_primary_button_cb(ButtonEvent event, button_callback_t cb);
 void unregister_primary_button_cb(ButtonEvent event);
 float convert_adc_to_axis(int adc_value, int min_val, int mid_val, int max_val, int deadband, float expo, bool invert);
+AxisCalibration get_x_axis_calibration();
+AxisCalibration get_y_axis_calibration();
+void axis_lut_update(AxisLut *lut, const AxisCalibration *calibration);
+float axis_lut_convert(const AxisLut *lut, int adc_value);
+float axis_lut_convert_held(const AxisLut *lut, int adc_value, float current);
+PackedRemoteData pack_remote_data(const RemoteData *data);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "session_key.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "mbedtls/md.h"
+#include <string.h>
+
+static const char *TAG = "PUBREMOTE-SESSION_KEY";
+
+#define SHA256_SIZE 32
+
+esp_err_t session_key_derive(uint32_t secret_code, const uint8_t *receiver_mac, uint8_t *key) {
+  uint8_t secret[4] = {secret_code >> 24, secret_code >> 16, secret_code >> 8, secret_code};
+
+  uint8_t message[sizeof(SESSION_KEY_LABEL) - 1 + 2 * ESP_NOW_ETH_ALEN];
+  memcpy(message, SESSION_KEY_LABEL, sizeof(SESSION_KEY_LABEL) - 1);
+  uint8_t *remote_mac = message + sizeof(SESSION_KEY_LABEL) - 1;
+  esp_err_t err = esp_read_mac(remote_mac, ESP_MAC_WIFI_STA);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to read MAC: %s", esp_err_to_name(err));
+    return err;
+  }
+  memcpy(remote_mac + ESP_NOW_ETH_ALEN, receiver_mac, ESP_NOW_ETH_ALEN);
+
+  uint8_t digest[SHA256_SIZE];
+  if (mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), secret, sizeof(secret), message, sizeof(message),
+                      digest) != 0) {
+    ESP_LOGE(TAG, "Failed to derive session key");
+    return ESP_FAIL;
+  }
+
+  memcpy(key, digest, ESP_NOW_KEY_LEN);
+  // Don't leave key material on the stack
+  memset(digest, 0, sizeof(digest));
+  return ESP_OK;
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef __SESSION_KEY_H
+#define __SESSION_KEY_H
+#include <esp_err.h>
+#include <esp_now.h>
+#include <stdio.h>
+
+// ESP-NOW local master key for a paired receiver: the first ESP_NOW_KEY_LEN bytes of
+// HMAC-SHA256(secret code, SESSION_KEY_LABEL | remote MAC | receiver MAC). The secret code is the one agreed during
+// REM_PAIR_BOND, big endian. Both ends derive the same key once per connection, frames are then sealed and opened by
+// the WiFi hardware (CCMP) at no extra cost per frame.
+//
+// This is obfuscation keyed by the pairing, not key agreement. The secret code is only 32 bits and crosses the air in
+// the clear during REM_PAIR_BOND, so anyone who captured the pairing, or who tries all 2^32 codes against one captured
+// frame, has the key. It keeps passive listeners and devices that missed the pairing off the link, nothing more.
+#define SESSION_KEY_LABEL "PubRemote LMK v1"
+
+esp_err_t session_key_derive(uint32_t secret_code, const uint8_t *receiver_mac, uint8_t *key);
+
+#endif
@@ -4,6 +4,7 @@
 #include "esp_system.h"
 #include "nvs_flash.h"
 #include "remote/adc.h"
+#include "stats.h"
 #include "string.h"
 #include <colors.h>
 #include <stdio.h>
@@ -297,6 +298,11 @@ void save_device_settings() {
   nvs_write_int("battery_display", device_settings.battery_display);
   nvs_write_int("pocket_mode", device_settings.pocket_mode);
   nvs_write_int("stats_dp", device_settings.double_press_action);
+  nvs_write_int("tx_burst", device_settings.tx_burst_count);
+  nvs_write_int("group_mode", device_settings.group_mode);
+
+  // Stats labels are formatted with the unit settings, redraw them in case the units changed
+  stats_update(STATS_FIELD_UNITS);
 }
 
 esp_err_t save_wifi_ssid(const char *ssid) {
@@ -507,6 +513,15 @@ esp_err_t settings_init() {
                                             ? (StatsDoublePressAction)temp_setting_value
                                             : DEFAULT_DOUBLE_PRESS_ACTION;
 
+  device_settings.tx_burst_count =
+      nvs_read_int("tx_burst", &temp_setting_value) == ESP_OK && temp_setting_value >= 1 &&
+              temp_setting_value <= MAX_TX_BURST_COUNT
+          ? (uint8_t)temp_setting_value
+          : DEFAULT_TX_BURST_COUNT;
+
+  device_settings.group_mode =
+      nvs_read_int("group_mode", &temp_setting_value) == ESP_OK ? (bool)temp_setting_value : false;
+
   // Reading calibration settings
   calibration_settings.x_min =
       nvs_read_int("x_min", &temp_setting_value) == ESP_OK ? (uint16_t)temp_setting_value : STICK_MIN_VAL;
@@ -91,6 +91,9 @@ typedef enum {
 } StatsDoublePressAction;
 
 #define DEFAULT_PAIRING_SECRET_CODE -1
+// Copies sent for critical input transitions, 1 disables bursts
+#define DEFAULT_TX_BURST_COUNT 3
+#define MAX_TX_BURST_COUNT 5
 
 typedef struct {
   uint32_t secret_code;
@@ -122,6 +125,8 @@ typedef struct {
   BoardBatteryDisplayOption battery_display;
   PocketModeOptions pocket_mode;
   StatsDoublePressAction double_press_action;
+  uint8_t tx_burst_count;
+  bool group_mode; // Drive every receiver in the peer roster
 } DeviceSettings;
 
 uint64_t get_auto_off_ms();
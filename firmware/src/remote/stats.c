@@ -1,31 +1,154 @@
 #include "stats.h"
+#include "display.h"
 #include "receiver.h"
 #include <screens/stats_screen.h>
+#include <freertos/FreeRTOS.h>
+#include <stdatomic.h>
+#include <string.h>
 
-RemoteStats remoteStats;
+// Seqlock around the published snapshot. Writers are serialised by the spinlock and bump the sequence to odd while
+// copying, readers retry until they see the same even sequence before and after their copy
+static RemoteStats stats_draft;
+static RemoteStats stats_published;
+static atomic_uint stats_sequence = 0;
+static portMUX_TYPE stats_writer_lock = portMUX_INITIALIZER_UNLOCKED;
 
 static callback_registry_t stats_update_registry = {0};
 
-void stats_update() {
+// Mailbox between producers and the LVGL task. Producers only set field bits, so they never wait on the display lock,
+// and any number of updates within one refresh period coalesce into a single UI pass
+static atomic_uint stats_dirty_mask = 0;
+static StatsFieldMask stats_update_mask = STATS_FIELD_NONE;
+static lv_timer_t *stats_ui_timer = NULL;
+
+void stats_update(StatsFieldMask mask) {
+  atomic_fetch_or(&stats_dirty_mask, mask);
+}
+
+StatsFieldMask stats_get_update_mask() {
+  return stats_update_mask;
+}
+
+// Runs in the LVGL task with the LVGL lock held
+static void stats_ui_timer_cb(lv_timer_t *timer) {
+  StatsFieldMask mask = atomic_exchange(&stats_dirty_mask, STATS_FIELD_NONE);
+  if (mask == STATS_FIELD_NONE) {
+    return;
+  }
+
+  stats_update_mask = mask;
   registry_cb(&stats_update_registry, false);
+  stats_update_mask = STATS_FIELD_NONE;
+}
+
+static StatsFieldMask get_changed_fields(const RemoteStats *prev, const RemoteStats *next) {
+  StatsFieldMask mask = STATS_FIELD_NONE;
+
+  if (prev->speed != next->speed) {
+    mask |= STATS_FIELD_SPEED;
+  }
+  if (prev->dutyCycle != next->dutyCycle) {
+    mask |= STATS_FIELD_DUTY_CYCLE;
+  }
+  if (prev->batteryVoltage != next->batteryVoltage || prev->batteryPercentage != next->batteryPercentage) {
+    mask |= STATS_FIELD_BATTERY;
+  }
+  if (prev->remoteBatteryVoltage != next->remoteBatteryVoltage ||
+      prev->remoteBatteryPercentage != next->remoteBatteryPercentage) {
+    mask |= STATS_FIELD_REMOTE_BATTERY;
+  }
+  if (prev->chargeState != next->chargeState || prev->chargeCurrent != next->chargeCurrent) {
+    mask |= STATS_FIELD_CHARGE;
+  }
+  if (prev->tripDistance != next->tripDistance) {
+    mask |= STATS_FIELD_TRIP_DISTANCE;
+  }
+  if (prev->motorTemp != next->motorTemp || prev->controllerTemp != next->controllerTemp) {
+    mask |= STATS_FIELD_TEMPS;
+  }
+  if (prev->signalStrength != next->signalStrength) {
+    mask |= STATS_FIELD_SIGNAL;
+  }
+  if (prev->state != next->state) {
+    mask |= STATS_FIELD_STATE;
+  }
+  if (prev->switchState != next->switchState) {
+    mask |= STATS_FIELD_SWITCH;
+  }
+  if (prev->motorCurrent != next->motorCurrent || prev->rpm != next->rpm) {
+    mask |= STATS_FIELD_MOTOR;
+  }
+  if (prev->odometer != next->odometer) {
+    mask |= STATS_FIELD_ODOMETER;
+  }
+  if (prev->faultCode != next->faultCode) {
+    mask |= STATS_FIELD_FAULT;
+  }
+  if (prev->rxPacketLoss != next->rxPacketLoss || prev->txPacketLoss != next->txPacketLoss) {
+    mask |= STATS_FIELD_LINK;
+  }
+
+  return mask;
+}
+
+RemoteStats *stats_begin_update() {
+  taskENTER_CRITICAL(&stats_writer_lock);
+  return &stats_draft;
+}
+
+void stats_publish() {
+  StatsFieldMask mask = get_changed_fields(&stats_published, &stats_draft);
+
+  atomic_fetch_add_explicit(&stats_sequence, 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  memcpy(&stats_published, &stats_draft, sizeof(stats_published));
+  atomic_fetch_add_explicit(&stats_sequence, 1, memory_order_release);
+  taskEXIT_CRITICAL(&stats_writer_lock);
+
+  if (mask != STATS_FIELD_NONE) {
+    stats_update(mask);
+  }
+}
+
+void stats_read_snapshot(RemoteStats *out) {
+  while (1) {
+    unsigned int start = atomic_load_explicit(&stats_sequence, memory_order_acquire);
+    if (start & 1) {
+      // Writer mid-copy on the other core
+      continue;
+    }
+
+    memcpy(out, &stats_published, sizeof(*out));
+    atomic_thread_fence(memory_order_acquire);
+
+    if (atomic_load_explicit(&stats_sequence, memory_order_relaxed) == start) {
+      return;
+    }
+  }
 }
 
 static void reset_stats() {
-  remoteStats.lastUpdated = 0;
-  remoteStats.speed = 0.0;
-  remoteStats.dutyCycle = 0;
-  remoteStats.speedUnit = SPEED_UNIT_KMH;
-  remoteStats.tempUnit = TEMP_UNIT_CELSIUS;
-  remoteStats.batteryVoltage = 0.0;
-  remoteStats.batteryPercentage = 0.0;
-  remoteStats.tripDistance = 0.0;
-  remoteStats.motorTemp = 0;
-  remoteStats.controllerTemp = 0;
-  remoteStats.signalStrength = -255;
-  remoteStats.state = BOARD_STATE_STARTUP;
-  remoteStats.switchState = SWITCH_STATE_OFF;
-
-  stats_update();
+  RemoteStats *stats = stats_begin_update();
+  stats->lastUpdated = 0;
+  stats->speed = 0.0;
+  stats->dutyCycle = 0;
+  stats->speedUnit = SPEED_UNIT_KMH;
+  stats->tempUnit = TEMP_UNIT_CELSIUS;
+  stats->batteryVoltage = 0.0;
+  stats->batteryPercentage = 0.0;
+  stats->tripDistance = 0.0;
+  stats->motorTemp = 0;
+  stats->controllerTemp = 0;
+  stats->signalStrength = -255;
+  stats->state = BOARD_STATE_STARTUP;
+  stats->switchState = SWITCH_STATE_OFF;
+  stats->motorCurrent = 0;
+  stats->rpm = 0;
+  stats->odometer = 0;
+  stats->faultCode = 0;
+  stats->rxPacketLoss = 0;
+  stats->txPacketLoss = 0;
+  stats_publish();
 }
 
 void stats_init() {
@@ -35,6 +158,11 @@ void stats_init() {
 void stats_register_update_cb(callback_t callback) {
   // Register the callback for stats updates
   register_cb(&stats_update_registry, callback);
+
+  if (stats_ui_timer == NULL && LVGL_lock(-1)) {
+    stats_ui_timer = lv_timer_create(stats_ui_timer_cb, LV_DISP_DEF_REFR_PERIOD, NULL);
+    LVGL_unlock();
+  }
 }
 
 void stats_unregister_update_cb(callback_t callback) {
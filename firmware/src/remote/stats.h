@@ -58,11 +58,52 @@ typedef struct {
   BoardState state;
   // Footpad switch state
   SwitchState switchState;
+  // Board motor current
+  float motorCurrent;
+  // Motor RPM
+  int16_t rpm;
+  // Board odometer, stored in meters
+  uint32_t odometer;
+  // Last reported fault code
+  uint8_t faultCode;
+  // Percentage of board frames missed, from sequence gaps
+  uint8_t rxPacketLoss;
+  // Percentage of remote frames not acknowledged by the receiver
+  uint8_t txPacketLoss;
 } RemoteStats;
 
-extern RemoteStats remoteStats;
+// Which RemoteStats fields changed since the UI last consumed them
+typedef enum {
+  STATS_FIELD_NONE = 0,
+  STATS_FIELD_SPEED = 1 << 0,
+  STATS_FIELD_DUTY_CYCLE = 1 << 1,
+  STATS_FIELD_BATTERY = 1 << 2,        // Board battery voltage and percentage
+  STATS_FIELD_REMOTE_BATTERY = 1 << 3, // Remote battery voltage and percentage
+  STATS_FIELD_CHARGE = 1 << 4,         // Remote charge state and current
+  STATS_FIELD_TRIP_DISTANCE = 1 << 5,
+  STATS_FIELD_TEMPS = 1 << 6, // Motor and controller temperature
+  STATS_FIELD_SIGNAL = 1 << 7,
+  STATS_FIELD_STATE = 1 << 8,
+  STATS_FIELD_SWITCH = 1 << 9,
+  STATS_FIELD_UNITS = 1 << 10, // Not a RemoteStats field, set when the unit settings are saved
+  STATS_FIELD_MOTOR = 1 << 11, // Motor current and RPM
+  STATS_FIELD_ODOMETER = 1 << 12,
+  STATS_FIELD_FAULT = 1 << 13,
+  STATS_FIELD_LINK = 1 << 14,       // Packet loss in both directions
+  STATS_FIELD_CONNECTION = 1 << 15, // Not a RemoteStats field, set when the connection state changes
+  STATS_FIELD_ALL = (1 << 16) - 1,
+} StatsFieldMask;
+
+// Writers: stats_begin_update() takes the writer lock and returns the draft, stats_publish() makes the draft visible
+// to readers, marks the fields that changed and releases the lock. The lock is a spinlock so keep the update to plain
+// field assignments.
+// Readers: stats_read_snapshot() copies a consistent snapshot without taking any lock.
+RemoteStats *stats_begin_update();
+void stats_publish();
+void stats_read_snapshot(RemoteStats *out);
 
-void stats_update();
+void stats_update(StatsFieldMask mask);
+StatsFieldMask stats_get_update_mask();
 void stats_init();
 void stats_register_update_cb(callback_t callback);
 void stats_unregister_update_cb(callback_t callback);
@@ -0,0 +1,172 @@
+#include "telemetry.h"
+#include "utilities/buffer_utils.h"
+#include <esp_log.h>
+
+static const char *TAG = "PUBREMOTE-TELEMETRY";
+
+// Wire size of each field, indexed by TelemetryField
+static const uint8_t telemetry_field_size[TELEMETRY_FIELD_COUNT] = {
+    [TELEMETRY_FIELD_SPEED] = 2,
+    [TELEMETRY_FIELD_DUTY_CYCLE] = 1,
+    [TELEMETRY_FIELD_BATTERY_VOLTAGE] = 2,
+    [TELEMETRY_FIELD_BATTERY_LEVEL] = 1,
+    [TELEMETRY_FIELD_MOTOR_TEMP] = 1,
+    [TELEMETRY_FIELD_CONTROLLER_TEMP] = 1,
+    [TELEMETRY_FIELD_STATE] = 1,
+    [TELEMETRY_FIELD_SWITCH_STATE] = 1,
+    [TELEMETRY_FIELD_TRIP_DISTANCE] = 4,
+    [TELEMETRY_FIELD_CURRENT] = 2,
+    [TELEMETRY_FIELD_RPM] = 2,
+    [TELEMETRY_FIELD_ODOMETER] = 4,
+    [TELEMETRY_FIELD_FAULT_CODE] = 1,
+    [TELEMETRY_FIELD_PITCH] = 2,
+    [TELEMETRY_FIELD_ROLL] = 2,
+};
+
+// Decoder for the active board. Only touched from the receiver task.
+static TelemetryDecoder active_decoder = {};
+
+static void decode_field(TelemetryField field, const uint8_t *data, TelemetryData *out) {
+  int32_t ind = 0;
+
+  switch (field) {
+  case TELEMETRY_FIELD_SPEED:
+    out->speed = buffer_get_int16(data, &ind) / 10.0;
+    break;
+  case TELEMETRY_FIELD_DUTY_CYCLE:
+    out->duty_cycle = (int8_t)data[0] / 100.0;
+    break;
+  case TELEMETRY_FIELD_BATTERY_VOLTAGE:
+    out->battery_voltage = buffer_get_int16(data, &ind) / 10.0;
+    break;
+  case TELEMETRY_FIELD_BATTERY_LEVEL:
+    out->battery_level = data[0] / 2.0;
+    break;
+  case TELEMETRY_FIELD_MOTOR_TEMP:
+    out->motor_temp = data[0] / 2.0;
+    break;
+  case TELEMETRY_FIELD_CONTROLLER_TEMP:
+    out->controller_temp = data[0] / 2.0;
+    break;
+  case TELEMETRY_FIELD_STATE:
+    out->state = data[0];
+    break;
+  case TELEMETRY_FIELD_SWITCH_STATE:
+    out->switch_state = data[0];
+    break;
+  case TELEMETRY_FIELD_TRIP_DISTANCE:
+    out->trip_distance = buffer_get_uint32(data, &ind);
+    break;
+  case TELEMETRY_FIELD_CURRENT:
+    out->current = buffer_get_int16(data, &ind) / 10.0;
+    break;
+  case TELEMETRY_FIELD_RPM:
+    out->rpm = buffer_get_int16(data, &ind);
+    break;
+  case TELEMETRY_FIELD_ODOMETER:
+    out->odometer = buffer_get_uint32(data, &ind);
+    break;
+  case TELEMETRY_FIELD_FAULT_CODE:
+    out->fault_code = data[0];
+    break;
+  case TELEMETRY_FIELD_PITCH:
+    out->pitch = buffer_get_int16(data, &ind) / 10.0;
+    break;
+  case TELEMETRY_FIELD_ROLL:
+    out->roll = buffer_get_int16(data, &ind) / 10.0;
+    break;
+  default:
+    break;
+  }
+}
+
+static TelemetryDecodeResult decode_frame(TelemetryDecoder *decoder, const uint8_t *data, int len, uint8_t *sequence,
+                                          TelemetryData *out) {
+  if (len < TELEMETRY_HEADER_SIZE) {
+    ESP_LOGE(TAG, "Frame too short: %d", len);
+    return TELEMETRY_DECODE_INVALID;
+  }
+
+  uint8_t version = data[0];
+  TelemetryFrameType frame_type = data[1];
+  uint8_t frame_sequence = data[2];
+  uint8_t frame_keyframe_id = data[3];
+  int32_t ind = 4;
+  uint16_t field_mask = buffer_get_uint16(data, &ind);
+
+  if (version != TELEMETRY_VERSION) {
+    ESP_LOGW(TAG, "Unsupported telemetry version: %d", version);
+    return TELEMETRY_DECODE_UNSUPPORTED_VERSION;
+  }
+
+  if (field_mask & ~TELEMETRY_FIELD_MASK_ALL) {
+    ESP_LOGE(TAG, "Unknown fields in mask: 0x%04x", field_mask);
+    return TELEMETRY_DECODE_INVALID;
+  }
+
+  if (frame_type == TELEMETRY_FRAME_KEY && field_mask != TELEMETRY_FIELD_MASK_ALL) {
+    ESP_LOGE(TAG, "Incomplete keyframe: 0x%04x", field_mask);
+    return TELEMETRY_DECODE_INVALID;
+  }
+  else if (frame_type != TELEMETRY_FRAME_KEY && frame_type != TELEMETRY_FRAME_DELTA) {
+    ESP_LOGE(TAG, "Unknown frame type: %d", frame_type);
+    return TELEMETRY_DECODE_INVALID;
+  }
+
+  // The mask fully determines the frame size, so check it before reading any field
+  int expected_len = TELEMETRY_HEADER_SIZE;
+  for (int field = 0; field < TELEMETRY_FIELD_COUNT; field++) {
+    if (field_mask & (1 << field)) {
+      expected_len += telemetry_field_size[field];
+    }
+  }
+
+  if (len != expected_len) {
+    ESP_LOGE(TAG, "Invalid frame length: %d != %d", len, expected_len);
+    return TELEMETRY_DECODE_INVALID;
+  }
+
+  // Valid frames count towards link loss even while deltas wait for a keyframe
+  *sequence = frame_sequence;
+
+  if (frame_type == TELEMETRY_FRAME_DELTA && (!decoder->has_keyframe || frame_keyframe_id != decoder->keyframe_id)) {
+    // Wait for the next keyframe
+    return TELEMETRY_DECODE_MISSING_KEYFRAME;
+  }
+
+  TelemetryData decoded = decoder->keyframe;
+  const uint8_t *field_data = data + TELEMETRY_HEADER_SIZE;
+
+  for (int field = 0; field < TELEMETRY_FIELD_COUNT; field++) {
+    if (field_mask & (1 << field)) {
+      decode_field(field, field_data, &decoded);
+      field_data += telemetry_field_size[field];
+    }
+  }
+
+  if (frame_type == TELEMETRY_FRAME_KEY) {
+    decoder->keyframe = decoded;
+    decoder->keyframe_id = frame_keyframe_id;
+    decoder->has_keyframe = true;
+  }
+
+  *out = decoded;
+  return TELEMETRY_DECODE_OK;
+}
+
+TelemetryDecodeResult telemetry_decode(const uint8_t *data, int len, uint8_t *sequence, TelemetryData *out) {
+  return decode_frame(&active_decoder, data, len, sequence, out);
+}
+
+// Drop the active board's keyframe so deltas wait for a keyframe from the board we are connecting to. Called from the
+// connection task, a delta racing with the reset is decoded against the old keyframe at worst once.
+void telemetry_reset() {
+  active_decoder.has_keyframe = false;
+}
+
+// Link statistics only follow the active board, so the sequence of other boards is not needed
+TelemetryDecodeResult telemetry_decode_peer(TelemetryDecoder *decoder, const uint8_t *data, int len,
+                                            TelemetryData *out) {
+  uint8_t sequence;
+  return decode_frame(decoder, data, len, &sequence, out);
+}
\ No newline at end of file
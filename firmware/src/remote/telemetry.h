@@ -0,0 +1,81 @@
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+#include <stdbool.h>
+#include <stdint.h>
+
+// REM_SET_TELEMETRY payload, following the command byte and the 4 byte secret code:
+// [version u8][frame type u8][sequence u8][keyframe id u8][field mask u16][fields...]
+// Multi-byte values are big endian. Fields are packed in ascending field order, each using the size listed below, so
+// the mask alone describes the layout of the frame.
+// A keyframe carries every field and replaces the stored keyframe. A delta carries only the fields that differ from the
+// keyframe with the same id and is applied on top of it, so a lost delta never corrupts the frames that follow.
+// The sequence increments on every frame, keyframe or delta, and is used to measure link loss.
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_HEADER_SIZE 6
+
+typedef enum {
+  TELEMETRY_FRAME_KEY = 0,
+  TELEMETRY_FRAME_DELTA = 1,
+} TelemetryFrameType;
+
+typedef enum {
+  TELEMETRY_FIELD_SPEED = 0,           // int16, m/s * 10
+  TELEMETRY_FIELD_DUTY_CYCLE = 1,      // int8, percent
+  TELEMETRY_FIELD_BATTERY_VOLTAGE = 2, // int16, V * 10
+  TELEMETRY_FIELD_BATTERY_LEVEL = 3,   // uint8, percent * 2
+  TELEMETRY_FIELD_MOTOR_TEMP = 4,      // uint8, C * 2
+  TELEMETRY_FIELD_CONTROLLER_TEMP = 5, // uint8, C * 2
+  TELEMETRY_FIELD_STATE = 6,           // uint8, BoardState
+  TELEMETRY_FIELD_SWITCH_STATE = 7,    // uint8, SwitchState
+  TELEMETRY_FIELD_TRIP_DISTANCE = 8,   // uint32, m
+  TELEMETRY_FIELD_CURRENT = 9,         // int16, A * 10
+  TELEMETRY_FIELD_RPM = 10,            // int16
+  TELEMETRY_FIELD_ODOMETER = 11,       // uint32, m
+  TELEMETRY_FIELD_FAULT_CODE = 12,     // uint8
+  TELEMETRY_FIELD_PITCH = 13,          // int16, degrees * 10
+  TELEMETRY_FIELD_ROLL = 14,           // int16, degrees * 10
+  TELEMETRY_FIELD_COUNT
+} TelemetryField;
+
+#define TELEMETRY_FIELD_MASK_ALL ((uint16_t)((1 << TELEMETRY_FIELD_COUNT) - 1))
+
+typedef struct {
+  float speed; // m/s
+  float duty_cycle;
+  float battery_voltage;
+  float battery_level;
+  float motor_temp;
+  float controller_temp;
+  uint8_t state;
+  uint8_t switch_state;
+  float trip_distance; // m
+  float current;
+  int16_t rpm;
+  uint32_t odometer; // m
+  uint8_t fault_code;
+  float pitch;
+  float roll;
+} TelemetryData;
+
+typedef enum {
+  TELEMETRY_DECODE_OK,
+  TELEMETRY_DECODE_INVALID,
+  TELEMETRY_DECODE_UNSUPPORTED_VERSION,
+  TELEMETRY_DECODE_MISSING_KEYFRAME,
+} TelemetryDecodeResult;
+
+// Last keyframe received from one board, deltas are applied on top of a copy of it
+typedef struct {
+  TelemetryData keyframe;
+  uint8_t keyframe_id;
+  bool has_keyframe;
+} TelemetryDecoder;
+
+void telemetry_reset();
+// Decodes a frame of the active board. sequence is set for OK and MISSING_KEYFRAME results, the caller tracks it for
+// link loss and duplicates.
+TelemetryDecodeResult telemetry_decode(const uint8_t *data, int len, uint8_t *sequence, TelemetryData *out);
+TelemetryDecodeResult telemetry_decode_peer(TelemetryDecoder *decoder, const uint8_t *data, int len,
+                                            TelemetryData *out);
+
+#endif
@@ -5,15 +5,25 @@
 #include "esp_log.h"
 #include "esp_now.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "esp_wifi.h"
+#include "espnow.h"
+#include "group.h"
+#include "link_health.h"
+#include "link_stats.h"
+#include "peer_manager.h"
 #include "peers.h"
 #include "receiver.h"
 #include "remoteinputs.h"
 #include "screens/stats_screen.h"
+#include "stats.h"
 #include "time.h"
 #include <remote/settings.h>
+#include <freertos/queue.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "PUBREMOTE-TRANSMITTER";
@@ -21,38 +31,241 @@ static const char *TAG = "PUBREMOTE-TRANSMITTER";
 
 static int64_t last_send_time = 0;
 static TaskHandle_t transmitter_task_handle = NULL;
+static TransmitterLatencyStats latency_stats = {0};
+// ReceiverCapabilities advertised by the connected receiver, cleared on disconnect
+static uint8_t receiver_capabilities = 0;
+// Incremented for every packed input frame
+static uint8_t tx_sequence = 0;
+// Set by the send callback when a frame was not acknowledged, the next send counts as a retry
+static atomic_bool retry_pending = false;
+// Delivery results from the send callback, only consumed while sending a burst
+static QueueHandle_t send_result_queue = NULL;
+// Lower 32 bits of the time the first unsent input change was seen, 0 when nothing is pending
+static atomic_uint_fast32_t input_changed_time_us = 0;
+// Lower 32 bits of the time the last frame to the active receiver was acknowledged
+static atomic_uint_fast32_t last_delivery_time_ms = 0;
+
+// Called from the input task and button callbacks whenever remote_data changes
+void transmitter_notify_input_changed() {
+  uint_fast32_t expected = 0;
+  uint32_t now_us = (uint32_t)esp_timer_get_time() | 1;
+  // Keep the oldest pending change so latency covers the whole wait
+  atomic_compare_exchange_strong(&input_changed_time_us, &expected, now_us);
+
+  if (transmitter_task_handle != NULL) {
+    xTaskNotifyGive(transmitter_task_handle);
+  }
+}
+
+static void record_send_latency(bool is_input_change) {
+  uint32_t changed_time_us = atomic_exchange(&input_changed_time_us, 0);
+
+  if (!is_input_change || changed_time_us == 0) {
+    latency_stats.keepalive_frames++;
+    return;
+  }
+
+  // Same rounding as the stored time, so a send in the same microsecond does not wrap to a huge latency
+  uint32_t latency_us = ((uint32_t)esp_timer_get_time() | 1) - changed_time_us;
+  latency_stats.input_frames++;
+  latency_stats.last_latency_us = latency_us;
+  latency_stats.total_latency_us += latency_us;
+  if (latency_us > latency_stats.max_latency_us) {
+    latency_stats.max_latency_us = latency_us;
+  }
+}
+
+TransmitterLatencyStats transmitter_get_latency_stats() {
+  return latency_stats;
+}
+
+// Applies the capabilities advertised by the receiver. Encryption is sticky for the connection: a capability frame
+// can turn it on but never off, so a forged or replayed frame can't downgrade an encrypted link. It is only dropped by
+// reset_receiver_capabilities on disconnect.
+void transmitter_set_receiver_capabilities(uint8_t capabilities) {
+  if (peer_manager_is_encrypted()) {
+    capabilities |= RECEIVER_CAPABILITY_ENCRYPTION;
+  }
+
+  if (capabilities != receiver_capabilities) {
+    ESP_LOGI(TAG, "Receiver capabilities: 0x%02x", capabilities);
+  }
+  receiver_capabilities = capabilities;
+
+  bool should_encrypt = capabilities & RECEIVER_CAPABILITY_ENCRYPTION;
+  if (should_encrypt != peer_manager_is_encrypted() && receiver_lock_channel()) {
+    peer_manager_set_encryption(should_encrypt);
+    receiver_unlock_channel();
+  }
+}
+
+static void reset_receiver_capabilities() {
+  receiver_capabilities = 0;
+
+  if (peer_manager_is_encrypted() && receiver_lock_channel()) {
+    peer_manager_set_encryption(false);
+    receiver_unlock_channel();
+  }
+}
 
 static void on_data_sent(const uint8_t *mac_addr, esp_now_send_status_t status) {
   // This callback runs in WiFi task context!
+  if (!is_same_mac(mac_addr, pairing_settings.remote_addr)) {
+    // Group member, keep it out of the active link's statistics and bursts
+    group_record_delivery(mac_addr, status == ESP_NOW_SEND_SUCCESS);
+    return;
+  }
+
+  if (send_result_queue != NULL) {
+    xQueueSend(send_result_queue, &status, 0);
+  }
+
+  link_health_record_tx(status == ESP_NOW_SEND_SUCCESS);
+
   if (status == ESP_NOW_SEND_SUCCESS) {
+    atomic_store(&last_delivery_time_ms, (uint32_t)get_current_time_ms());
     ESP_LOGD(TAG, "Data sent successfully to %02X:%02X:%02X:%02X:%02X:%02X", mac_addr[0], mac_addr[1], mac_addr[2],
              mac_addr[3], mac_addr[4], mac_addr[5]);
   }
   else {
+    link_stats_record_tx_delivery_failure();
+
     if (connection_state == CONNECTION_STATE_CONNECTED) {
       ESP_LOGE(TAG, "Failed to send data to %02X:%02X:%02X:%02X:%02X:%02X", mac_addr[0], mac_addr[1], mac_addr[2],
                mac_addr[3], mac_addr[4], mac_addr[5]);
       last_send_time = 0; // Reset last send time on failure to ensure we send in the next cycle
+      atomic_store(&retry_pending, true);
     }
   }
 }
 
-static uint8_t get_peer_channel(const uint8_t *peer_mac) {
-  esp_now_peer_info_t peer_info = {0};
+// Keepalive interval when idle, also the slowest rate receivers expect to hear from us
+#define MAX_UPDATE_DELAY_MS 500
+// Keepalive interval while riding or moving the stick
+#define ACTIVE_UPDATE_DELAY_MS 100
+// Stay active for this long after the last input change
+#define ACTIVE_INPUT_HOLD_MS 2000
+// Delivery loss thresholds for backing off the keepalive and retry rate
+#define BACKOFF_LOSS_PCT 20
+#define HEAVY_BACKOFF_LOSS_PCT 50
+// The board stops after 1 s without input. While it is running and nothing got through for this long, stop backing
+// off and repeat at the input rate until a frame is acknowledged.
+#define RUNNING_SILENCE_LIMIT_MS 500
 
-  esp_err_t result = esp_now_get_peer(peer_mac, &peer_info);
-  if (result != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to get peer info: %s", esp_err_to_name(result));
-    return 0; // Return 0 to indicate error
+static int64_t last_input_change_time = 0;
+
+static bool is_board_running(BoardState state) {
+  return state == BOARD_STATE_RUNNING || state == BOARD_STATE_RUNNING_TILTBACK ||
+         state == BOARD_STATE_RUNNING_WHEELSLIP || state == BOARD_STATE_RUNNING_UPSIDEDOWN ||
+         state == BOARD_STATE_RUNNING_FLYWHEEL;
+}
+
+static bool is_running_link_silent(int64_t now, const RemoteStats *stats) {
+  return is_board_running(stats->state) &&
+         (uint32_t)now - atomic_load(&last_delivery_time_ms) >= RUNNING_SILENCE_LIMIT_MS;
+}
+
+// Each step doubles the keepalive and retry intervals
+static uint8_t get_backoff_shift(int64_t now, const RemoteStats *stats) {
+  if (is_running_link_silent(now, stats)) {
+    return 0;
+  }
+  else if (stats->txPacketLoss >= HEAVY_BACKOFF_LOSS_PCT) {
+    return 2;
+  }
+  else if (stats->txPacketLoss >= BACKOFF_LOSS_PCT) {
+    return 1;
   }
 
-  return peer_info.channel;
+  return 0;
 }
 
-#define MAX_UPDATE_DELAY_MS 500
+// Input changes are always sent immediately, this only sets how often unchanged input is repeated
+static int64_t get_keepalive_interval_ms(int64_t now, const RemoteStats *stats) {
+  bool is_active = now - last_input_change_time < ACTIVE_INPUT_HOLD_MS || is_board_running(stats->state);
+
+  if (!is_active) {
+    return MAX_UPDATE_DELAY_MS;
+  }
+
+  if (is_running_link_silent(now, stats)) {
+    return TX_RATE_MS;
+  }
+
+  int64_t interval = ACTIVE_UPDATE_DELAY_MS << get_backoff_shift(now, stats);
+  return interval < MAX_UPDATE_DELAY_MS ? interval : MAX_UPDATE_DELAY_MS;
+}
+
+// A throttle step of at least this much (in packed units, 1/100) is sent as a burst
+#define BURST_THROTTLE_STEP 25
+// Time to wait for a copy to be acknowledged before sending the next one
+#define BURST_SPACING_MS 5
+#define SEND_RESULT_QUEUE_SIZE 4
+
+// Button changes and large throttle steps are the transitions a single lost frame would hurt most
+static bool is_critical_transition(const PackedRemoteData *last, const PackedRemoteData *current) {
+  return last->buttons != current->buttons || abs(current->js_y - last->js_y) >= BURST_THROTTLE_STEP;
+}
+
+// Called after the first copy of data was accepted by esp_now_send. Sends further copies with the same sequence until
+// one is acknowledged or copies frames have been sent.
+static void send_burst(const uint8_t *mac_addr, const uint8_t *data, uint8_t len, uint8_t copies) {
+  uint8_t sent = 1;
+  // A late ack of an earlier copy also ends the burst, only a reported failure shows the extra copies were needed
+  bool has_failed = false;
+
+  while (1) {
+    esp_now_send_status_t status;
+    if (xQueueReceive(send_result_queue, &status, pdMS_TO_TICKS(BURST_SPACING_MS)) == pdTRUE) {
+      if (status == ESP_NOW_SEND_SUCCESS) {
+        // Delivered, no need for the remaining copies
+        atomic_store(&retry_pending, false);
+        link_stats_record_tx_burst(sent, sent > 1 && has_failed);
+        return;
+      }
+
+      has_failed = true;
+    }
+
+    if (sent >= copies) {
+      break;
+    }
+
+    if (esp_now_send(mac_addr, data, len) != ESP_OK) {
+      link_stats_record_tx_send_failure();
+      break;
+    }
+
+    link_stats_record_tx();
+    sent++;
+  }
+
+  link_stats_record_tx_burst(sent, false);
+}
+
+// Sleep until an input change is notified or the keepalive is due
+static TickType_t get_wait_ticks(bool is_transmitting, bool is_retry_due, int64_t now, int64_t keepalive_interval,
+                                 const RemoteStats *stats) {
+  if (!is_transmitting) {
+    // Poll for the stats screen or connection state allowing transmission again
+    return pdMS_TO_TICKS(TX_RATE_MS);
+  }
+
+  int64_t remaining = keepalive_interval - (now - last_send_time);
+  // Pace retries after a failed send, slower while the link is dropping frames
+  int64_t retry_interval = TX_RATE_MS << get_backoff_shift(now, stats);
+  // A frame that never went out leaves the last sent message and time as they were, so nothing else brings the
+  // retry forward
+  if (is_retry_due || remaining < retry_interval) {
+    remaining = retry_interval;
+  }
+
+  return pdMS_TO_TICKS(remaining);
+}
 
 // Function to send ESP-NOW data
 static void transmitter_task(void *pvParameters) {
+  send_result_queue = xQueueCreate(SEND_RESULT_QUEUE_SIZE, sizeof(esp_now_send_status_t));
   ESP_ERROR_CHECK(esp_now_register_send_cb(on_data_sent));
   ESP_LOGI(TAG, "Registered RX callback");
 
@@ -60,7 +273,7 @@ static void transmitter_task(void *pvParameters) {
   uint8_t ind = 0;
   uint8_t data[100];
 
-  RemoteData last_message = {};
+  PackedRemoteData last_message = {};
   ConnectionState last_connection_state = connection_state;
   bool should_emit_version = false;
   while (1) {
@@ -68,19 +281,42 @@ static void transmitter_task(void *pvParameters) {
       should_emit_version = true;
     }
 
+    if (connection_state == CONNECTION_STATE_DISCONNECTED && receiver_capabilities != 0) {
+      // Next receiver has to advertise its capabilities again, and starts unencrypted
+      reset_receiver_capabilities();
+    }
+
     int64_t new_time = get_current_time_ms();
+    RemoteStats stats;
+    stats_read_snapshot(&stats);
 
     bool should_transmit =
         is_stats_screen_active() && !is_pocket_mode_enabled() &&
         (connection_state == CONNECTION_STATE_CONNECTED || connection_state == CONNECTION_STATE_RECONNECTING ||
          connection_state == CONNECTION_STATE_CONNECTING);
 
+    bool is_transmitting = should_transmit;
+    bool is_retry_due = false;
+    // Snapshot inputs once so change detection and the frame agree. Comparing the packed form ignores float noise
+    // such as -0.0 and struct padding.
+    RemoteData current_data = remote_data;
+    PackedRemoteData packed_data = pack_remote_data(&current_data);
+    bool has_changed = memcmp(&packed_data, &last_message, sizeof(packed_data)) != 0;
+
+    if (has_changed) {
+      last_input_change_time = new_time;
+    }
+
+    int64_t keepalive_interval = get_keepalive_interval_ms(new_time, &stats);
+    latency_stats.keepalive_interval_ms = keepalive_interval;
+
     if (should_transmit) {
       // Check if data is the same as last time
-      if (memcmp(&remote_data, &last_message, sizeof(remote_data)) == 0 &&
-          new_time - last_send_time < MAX_UPDATE_DELAY_MS) {
+      if (!has_changed && new_time - last_send_time < keepalive_interval) {
         // No change in data, skip transmission
         should_transmit = false;
+        // Input returned to the last sent value before we got to it
+        atomic_store(&input_changed_time_us, 0);
       }
     }
     else {
@@ -89,18 +325,33 @@ static void transmitter_task(void *pvParameters) {
     }
 
     if (should_transmit) {
-      data[0] = REM_SET_INPUT_STATE;
-      ind++;
+      bool use_packed_input = receiver_capabilities & RECEIVER_CAPABILITY_PACKED_INPUT;
+      data[ind++] = use_packed_input ? REM_SET_INPUT_STATE_PACKED : REM_SET_INPUT_STATE;
 
       memcpy(data + ind, &pairing_settings.secret_code, sizeof(int32_t));
       ind += sizeof(int32_t);
 
-      // Copy remote_data.bytes after secret_Code
-      memcpy(data + ind, &remote_data, sizeof(remote_data));
-      ind += sizeof(remote_data);
+      if (use_packed_input) {
+        data[ind++] = (uint8_t)packed_data.js_y;
+        data[ind++] = (uint8_t)packed_data.js_x;
+        data[ind++] = packed_data.buttons;
+        data[ind++] = tx_sequence;
+      }
+      else {
+        // Copy remote_data.bytes after secret_Code
+        memcpy(data + ind, &current_data, sizeof(current_data));
+        ind += sizeof(current_data);
+      }
+
+      uint8_t burst_count = is_critical_transition(&last_message, &packed_data) ? device_settings.tx_burst_count : 1;
 
       uint8_t *mac_addr = pairing_settings.remote_addr;
       if (receiver_lock_channel()) {
+        if (burst_count > 1) {
+          // Drop results of earlier frames so the burst only sees its own
+          xQueueReset(send_result_queue);
+        }
+
         esp_err_t result = esp_now_send(mac_addr, data, ind);
 
         if (result != ESP_OK) {
@@ -108,13 +359,34 @@ static void transmitter_task(void *pvParameters) {
           uint8_t chann = pairing_settings.channel;
           uint8_t wifi_chann;
           wifi_second_chan_t secondary_channel;
-          uint8_t peer_chann = get_peer_channel(mac_addr);
+          uint8_t peer_chann = peer_manager_get_channel();
           esp_wifi_get_channel(&wifi_chann, &secondary_channel);
           ESP_LOGE(TAG, "Error sending remote data: %d  - Channel: %d, WiFi Channel: %d, Peer Channel: %d", result,
                    chann, wifi_chann, peer_chann);
+          link_stats_record_tx_send_failure();
+          is_retry_due = true;
         }
         else {
-          memcpy(&last_message, &remote_data, sizeof(remote_data));
+          if (use_packed_input) {
+            tx_sequence++;
+          }
+
+          link_stats_record_tx();
+          if (atomic_exchange(&retry_pending, false)) {
+            link_stats_record_tx_retry();
+          }
+
+          if (burst_count > 1) {
+            send_burst(mac_addr, data, ind, burst_count);
+          }
+
+          // Batch the rest of the group behind the active receiver's frame
+          if (group_is_enabled()) {
+            group_send_input_state(&current_data);
+          }
+
+          record_send_latency(has_changed);
+          last_message = packed_data;
           last_send_time = new_time;
           ESP_LOGD(TAG, "Sent command");
         }
@@ -127,22 +399,29 @@ static void transmitter_task(void *pvParameters) {
           uint8_t version[3] = {VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH};
           memcpy(data + ind, &version, sizeof(version));
           ind += sizeof(version);
-          esp_now_send(mac_addr, data, ind);
+          if (esp_now_send(mac_addr, data, ind) == ESP_OK) {
+            link_stats_record_tx();
+          }
+          else {
+            link_stats_record_tx_send_failure();
+          }
           should_emit_version = false;
         }
 
         receiver_unlock_channel();
       }
+      else {
+        // Channel stayed busy, the frame was not sent
+        is_retry_due = true;
+      }
     }
     // Reset the index for the next data packet and clear the data buffer
     ind = 0;
     memset(data, 0, sizeof(data));
 
     last_connection_state = connection_state;
-    int64_t elapsed = get_current_time_ms() - last_send_time;
-    if (elapsed >= 0 && elapsed < TX_RATE_MS) {
-      vTaskDelay(pdMS_TO_TICKS(TX_RATE_MS - elapsed));
-    }
+    ulTaskNotifyTake(pdTRUE,
+                     get_wait_ticks(is_transmitting, is_retry_due, get_current_time_ms(), keepalive_interval, &stats));
   }
 
   // The task will not reach this point as it runs indefinitely
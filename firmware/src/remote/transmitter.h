@@ -16,7 +16,21 @@ typedef struct {
   uint16_t *results;
 } LatencyTestResults;
 
+// Stick-to-air latency, measured from the first input change to esp_now_send accepting the frame carrying it
+typedef struct {
+  uint32_t input_frames;
+  uint32_t keepalive_frames;
+  uint32_t last_latency_us;
+  uint32_t max_latency_us;
+  uint64_t total_latency_us;
+  // Current adaptive keepalive interval
+  uint32_t keepalive_interval_ms;
+} TransmitterLatencyStats;
+
 void transmitter_init();
 void transmitter_deinit();
+void transmitter_notify_input_changed();
+TransmitterLatencyStats transmitter_get_latency_stats();
+void transmitter_set_receiver_capabilities(uint8_t capabilities);
 
 #endif
\ No newline at end of file
@@ -74,22 +74,25 @@ static void monitor_task(void *pvParameters) {
 #if VEHICLE_STATE_DEBUG
   int count = 0;
 #endif
+  RemoteStats stats;
   while (1) {
 
 #if VEHICLE_STATE_DEBUG
-    remoteStats.dutyCycle = count;
-    stats_update();
+    RemoteStats *debug_stats = stats_begin_update();
+    debug_stats->dutyCycle = count;
+    stats_publish();
     count++;
     if (count >= 100) {
       count = 0;
     }
 #endif
 
-    DutyStatus current_duty_status = get_duty_status(remoteStats.dutyCycle);
-    bool is_duty_alert = get_duty_status(remoteStats.dutyCycle) != DUTY_STATUS_NONE;
+    stats_read_snapshot(&stats);
+    DutyStatus current_duty_status = get_duty_status(stats.dutyCycle);
+    bool is_duty_alert = get_duty_status(stats.dutyCycle) != DUTY_STATUS_NONE;
     if (current_duty_status != last_duty_status) {
       if (is_duty_alert) {
-        ESP_LOGW(TAG, "Duty cycle alert: %d%%", remoteStats.dutyCycle);
+        ESP_LOGW(TAG, "Duty cycle alert: %d%%", stats.dutyCycle);
         led_set_effect_solid(get_duty_color(current_duty_status));
         if (current_duty_status > last_duty_status) {
           // Duty cycle increased, alert with haptic and buzzer
@@ -98,7 +101,7 @@ static void monitor_task(void *pvParameters) {
         }
       }
       else {
-        ESP_LOGD(TAG, "Duty cycle normal: %d%%", remoteStats.dutyCycle);
+        ESP_LOGD(TAG, "Duty cycle normal: %d%%", stats.dutyCycle);
         led_set_effect_none();
         haptic_stop_vibration();
         buzzer_stop();
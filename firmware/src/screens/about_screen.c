@@ -29,12 +29,14 @@ static void update_version_info_label() {
 }
 
 static void update_battery_percentage_label() {
+  RemoteStats stats;
+  stats_read_snapshot(&stats);
   char *formattedString;
-  asprintf(&formattedString, "Battery: %.2fV | %d%%\nState: %s", ((float)remoteStats.remoteBatteryVoltage / 1000.0f),
-           remoteStats.remoteBatteryPercentage, charge_state_to_string(remoteStats.chargeState));
+  asprintf(&formattedString, "Battery: %.2fV | %d%%\nState: %s", ((float)stats.remoteBatteryVoltage / 1000.0f),
+           stats.remoteBatteryPercentage, charge_state_to_string(stats.chargeState));
 
-  if (remoteStats.chargeState != CHARGE_STATE_NOT_CHARGING && remoteStats.chargeCurrent > 0) {
-    asprintf(&formattedString, "%s\nCurrent: %umA", formattedString, remoteStats.chargeCurrent);
+  if (stats.chargeState != CHARGE_STATE_NOT_CHARGING && stats.chargeCurrent > 0) {
+    asprintf(&formattedString, "%s\nCurrent: %umA", formattedString, stats.chargeCurrent);
   }
 
   lv_label_set_text(ui_DebugInfoLabel, formattedString);
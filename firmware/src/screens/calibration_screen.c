@@ -8,6 +8,7 @@
 #include <remote/remoteinputs.h>
 #include <remote/settings.h>
 #include <screens/calibration_screen.h>
+#include <stdlib.h>
 #include <ui/ui.h>
 
 static const char *TAG = "PUBREMOTE-CALIBRATION_SCREEN";
@@ -143,27 +144,43 @@ static void update_stick_press_indicator() {
 }
 
 void calibration_task(void *pvParameters) {
+  // Preview tables only live while the screen is open, they are rebuilt when a step changes the preview calibration
+#if JOYSTICK_X_ENABLED
+  AxisLut *x_lut = calloc(1, sizeof(AxisLut));
+#endif
+#if JOYSTICK_Y_ENABLED
+  AxisLut *y_lut = calloc(1, sizeof(AxisLut));
+#endif
+
   while (is_calibration_screen_active()) {
     update_min_max();
 
-    if (LVGL_lock(-1)) {
-// Get values using current calibration data
+    // Conversion runs outside the LVGL lock since a table rebuild takes a while
 #if JOYSTICK_X_ENABLED
-      float curr_x_val =
-          convert_adc_to_axis(joystick_data.x, calibration_data.x_min, calibration_data.x_center,
-                              calibration_data.x_max, calibration_data.deadband, calibration_data.expo, false);
+    AxisCalibration x_calibration = {calibration_data.x_min,    calibration_data.x_center, calibration_data.x_max,
+                                     calibration_data.deadband, calibration_data.expo,     false};
+    float curr_x_val = 0;
+    if (x_lut != NULL) {
+      axis_lut_update(x_lut, &x_calibration);
+      curr_x_val = axis_lut_convert(x_lut, joystick_data.x);
+    }
 #else
-      float curr_x_val = 0;
+    float curr_x_val = 0;
 #endif
 
 #if JOYSTICK_Y_ENABLED
-      float curr_y_val = convert_adc_to_axis(joystick_data.y, calibration_data.y_min, calibration_data.y_center,
-                                             calibration_data.y_max, calibration_data.deadband, calibration_data.expo,
-                                             calibration_data.invert_y);
+    AxisCalibration y_calibration = {calibration_data.y_min,    calibration_data.y_center, calibration_data.y_max,
+                                     calibration_data.deadband, calibration_data.expo,     calibration_data.invert_y};
+    float curr_y_val = 0;
+    if (y_lut != NULL) {
+      axis_lut_update(y_lut, &y_calibration);
+      curr_y_val = axis_lut_convert(y_lut, joystick_data.y);
+    }
 #else
-      float curr_y_val = 0;
+    float curr_y_val = 0;
 #endif
 
+    if (LVGL_lock(-1)) {
       update_display_stick_label(curr_x_val, curr_y_val);
       update_display_stick_position(curr_x_val, curr_y_val);
       update_deadband_indicator();
@@ -175,6 +192,13 @@ void calibration_task(void *pvParameters) {
     vTaskDelay(pdMS_TO_TICKS(LV_DISP_DEF_REFR_PERIOD));
   }
 
+#if JOYSTICK_X_ENABLED
+  free(x_lut);
+#endif
+#if JOYSTICK_Y_ENABLED
+  free(y_lut);
+#endif
+
   ESP_LOGI(TAG, "Calibration task ended");
   vTaskDelete(NULL);
 }
@@ -1,6 +1,7 @@
 #include "config.h"
 #include "esp_log.h"
 #include "remote/display.h"
+#include "utilities/format_utils.h"
 #include "utilities/screen_utils.h"
 #include "utilities/string_utils.h"
 #include <remote/remoteinputs.h>
@@ -17,10 +18,12 @@ bool is_charge_screen_active() {
 }
 
 void update_charge_labels() {
-  char *formattedString;
-  asprintf(&formattedString, "%d%%", remoteStats.remoteBatteryPercentage);
-  lv_label_set_text(ui_ChargeInfoLevelLabel, formattedString);
-  free(formattedString);
+  RemoteStats stats;
+  stats_read_snapshot(&stats);
+  // Label points at this buffer so the once a second refresh never allocates
+  static char charge_level_text[FORMAT_NUMBER_BUFFER_SIZE];
+  snprintf(charge_level_text, sizeof(charge_level_text), "%d%%", stats.remoteBatteryPercentage);
+  lv_label_set_text_static(ui_ChargeInfoLevelLabel, charge_level_text);
 }
 
 void charge_task(void *pvParameters) {
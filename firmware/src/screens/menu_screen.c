@@ -86,7 +86,7 @@ void menu_connect_press(lv_event_t *e) {
     connection_connect_to_default_peer();
   }
   else {
-    connection_update_state(CONNECTION_STATE_DISCONNECTED);
+    connection_disconnect();
   }
 
   if (LVGL_lock(0)) {
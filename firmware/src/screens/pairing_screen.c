@@ -26,7 +26,7 @@ void pairing_screen_load_start(lv_event_t *e) {
 
 void pairing_screen_loaded(lv_event_t *e) {
   ESP_LOGI(TAG, "Pairing screen loaded");
-  connection_update_state(CONNECTION_STATE_DISCONNECTED);
+  connection_disconnect();
   pairing_state = PAIRING_STATE_UNPAIRED;
 }
 
@@ -1,6 +1,7 @@
 #include "screens/stats_screen.h"
 #include "esp_log.h"
 #include "remote/display.h"
+#include "remote/group.h"
 #include "remote/remoteinputs.h"
 #include "remote/vehicle_state.h"
 #include "utilities/screen_utils.h"
@@ -10,7 +11,10 @@
 #include <remote/connection.h>
 #include <remote/settings.h>
 #include <remote/stats.h>
+#include <stdio.h>
+#include <string.h>
 #include <utilities/conversion_utils.h>
+#include <utilities/format_utils.h>
 
 static const char *TAG = "PUBREMOTE-STATS_SCREEN";
 
@@ -33,71 +37,50 @@ bool is_stats_screen_active() {
   return active_screen == ui_StatsScreen;
 }
 
+// Labels point at these buffers with lv_label_set_text_static so updates never allocate
+#define STATS_LABEL_BUFFER_SIZE 32
+
+// Snapshot taken once per refresh so every widget renders the same set of values
+static RemoteStats stats;
 static uint8_t max_speed = 0;
 
+// Each update_*_display function is only called when the fields it renders are set in the update mask
 static void update_speed_dial_display() {
-  static float last_value = 0;
-
-  // Ensure the value has changed
-  if (last_value == remoteStats.speed) {
-    return;
-  }
-
   if (!max_speed) {
     /// get range from arc in case it was not set
     max_speed = lv_arc_get_max_value(ui_SpeedDial);
   }
 
-  if (remoteStats.speed > max_speed) {
-    max_speed = (uint8_t)remoteStats.speed;
+  if (stats.speed > max_speed) {
+    max_speed = (uint8_t)stats.speed;
     // Set range based on max speed
 
     lv_arc_set_range(ui_SpeedDial, 0, max_speed);
     // lv_bar_set_range(ui_SpeedBar, 0, max_speed);
   }
 
-  lv_arc_set_value(ui_SpeedDial, remoteStats.speed);
-  // lv_bar_set_value(ui_SpeedBar, remoteStats.speed, LV_ANIM_OFF);
-
-  // Update the last value
-  last_value = remoteStats.speed;
+  lv_arc_set_value(ui_SpeedDial, stats.speed);
+  // lv_bar_set_value(ui_SpeedBar, stats.speed, LV_ANIM_OFF);
 }
 
 static void update_utilization_dial_display() {
-  static uint8_t last_value = 0;
-
-  // Ensure the value has changed
-  if (last_value == remoteStats.dutyCycle) {
-    return;
-  }
-
-  lv_arc_set_value(ui_UtilizationDial, remoteStats.dutyCycle);
+  lv_arc_set_value(ui_UtilizationDial, stats.dutyCycle);
 
   // set arc color
   lv_color_t color = lv_color_hex(COLOR_ACTIVE);
 
-  DutyStatus duty_status = get_duty_status(remoteStats.dutyCycle);
+  DutyStatus duty_status = get_duty_status(stats.dutyCycle);
 
   if (duty_status != DUTY_STATUS_NONE) {
     color = lv_color_hex(get_duty_color(duty_status));
   }
 
   lv_obj_set_style_arc_color(ui_UtilizationDial, color, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-
-  // Update the last value
-  last_value = remoteStats.dutyCycle;
 }
 
 static void update_remote_battery_display() {
-  static uint8_t last_remote_battery_value = 0;
-
-  // Ensure the value has changed
-  if (last_remote_battery_value == remoteStats.remoteBatteryPercentage) {
-    return;
-  }
-
   // Set background to red below 20%
-  if (remoteStats.remoteBatteryPercentage < 20 && remoteStats.remoteBatteryPercentage != 0) {
+  if (stats.remoteBatteryPercentage < 20 && stats.remoteBatteryPercentage != 0) {
     lv_obj_set_style_bg_color(ui_BatteryFill, lv_color_hex(0xb20000), LV_PART_MAIN | LV_STATE_DEFAULT);
   }
   else {
@@ -105,10 +88,7 @@ static void update_remote_battery_display() {
   }
 
   // Set width of battery object
-  lv_obj_set_width(ui_BatteryFill, lv_pct(remoteStats.remoteBatteryPercentage));
-
-  // Update the last value
-  last_remote_battery_value = remoteStats.remoteBatteryPercentage;
+  lv_obj_set_width(ui_BatteryFill, lv_pct(stats.remoteBatteryPercentage));
 }
 
 static void update_rssi_display() {
@@ -116,13 +96,13 @@ static void update_rssi_display() {
   static uint8_t last_signal_strength_rating_value = SIGNAL_STRENGTH_NONE;
   SignalStrength signal_strength_rating = SIGNAL_STRENGTH_NONE;
 
-  if (remoteStats.signalStrength > RSSI_GOOD) {
+  if (stats.signalStrength > RSSI_GOOD) {
     signal_strength_rating = SIGNAL_STRENGTH_GOOD;
   }
-  else if (remoteStats.signalStrength > RSSI_FAIR) {
+  else if (stats.signalStrength > RSSI_FAIR) {
     signal_strength_rating = SIGNAL_STRENGTH_FAIR;
   }
-  else if (remoteStats.signalStrength > RSSI_POOR) {
+  else if (stats.signalStrength > RSSI_POOR) {
     signal_strength_rating = SIGNAL_STRENGTH_POOR;
   }
   else {
@@ -162,48 +142,57 @@ static void update_rssi_display() {
   last_signal_strength_rating_value = signal_strength_rating;
 }
 
-static void update_pocket_mode_display() {
-  // Hide pocket mode container on disconnect if not already hidden
+static void update_remote_mode_display() {
+  // Group mode shares the pocket mode label with the number of boards being driven, the active one included
+  static char remote_mode_text[STATS_LABEL_BUFFER_SIZE] = "";
+  bool is_pocket_mode = is_pocket_mode_enabled();
+  bool is_group_mode = group_is_enabled();
+  bool should_show = is_pocket_mode || is_group_mode;
+
+  // Hide remote mode container when neither mode is on if not already hidden
   // Otherwise, show the container if not already shown
-  if (!is_pocket_mode_enabled() && !lv_obj_has_flag(ui_RemoteModeContainer, LV_OBJ_FLAG_HIDDEN)) {
+  if (!should_show && !lv_obj_has_flag(ui_RemoteModeContainer, LV_OBJ_FLAG_HIDDEN)) {
     lv_obj_add_flag(ui_RemoteModeContainer, LV_OBJ_FLAG_HIDDEN);
   }
-  else if (is_pocket_mode_enabled() && lv_obj_has_flag(ui_RemoteModeContainer, LV_OBJ_FLAG_HIDDEN)) {
+  else if (should_show && lv_obj_has_flag(ui_RemoteModeContainer, LV_OBJ_FLAG_HIDDEN)) {
     lv_obj_clear_flag(ui_RemoteModeContainer, LV_OBJ_FLAG_HIDDEN);
   }
-}
-
-static void update_primary_stat_display() {
-  static float last_value = 0;
 
-  // Ensure the value has changed
-  if (last_value == remoteStats.speed) {
+  if (!should_show) {
     return;
   }
 
-  float converted_val = remoteStats.speed;
+  char text[STATS_LABEL_BUFFER_SIZE];
+  if (is_group_mode) {
+    uint8_t board_count = group_get_member_count() + (connection_state == CONNECTION_STATE_CONNECTED ? 1 : 0);
+    snprintf(text, sizeof(text), "%s%d BOARDS", is_pocket_mode ? "POCKET - " : "", board_count);
+  }
+  else {
+    snprintf(text, sizeof(text), "POCKET MODE");
+  }
 
-  if (device_settings.distance_units == DISTANCE_UNITS_IMPERIAL) {
-    converted_val = convert_kph_to_mph(remoteStats.speed);
+  // Ensure the value has changed
+  if (strcmp(text, remote_mode_text) == 0) {
+    return;
   }
 
-  char *formattedString;
+  strcpy(remote_mode_text, text);
+  lv_label_set_text_static(ui_RemoteModeText, remote_mode_text);
+}
 
-  if (converted_val >= 10) {
-    asprintf(&formattedString, "%.0f", converted_val);
-  }
-  else {
-    asprintf(&formattedString, "%.1f", converted_val);
-  }
+static void update_primary_stat_display() {
+  float converted_val = stats.speed;
 
-  lv_label_set_text(ui_PrimaryStat, formattedString);
-  free(formattedString);
+  if (device_settings.distance_units == DISTANCE_UNITS_IMPERIAL) {
+    converted_val = convert_kph_to_mph(stats.speed);
+  }
 
-  // Update the last value
-  last_value = remoteStats.speed;
+  static char primary_stat_text[FORMAT_NUMBER_BUFFER_SIZE];
+  format_fixed(primary_stat_text, sizeof(primary_stat_text), converted_val, converted_val >= 10 ? 0 : 1);
+  lv_label_set_text_static(ui_PrimaryStat, primary_stat_text);
 }
 
-static char *get_board_state_string(BoardState state) {
+static const char *get_board_state_string(BoardState state) {
   switch (state) {
   case BOARD_STATE_RUNNING_FLYWHEEL:
     return "FLYWHEEL";
@@ -219,35 +208,16 @@ static char *get_board_state_string(BoardState state) {
 }
 
 static void update_board_state_text() {
-  static char *last_board_state_string = NULL;
-
-  char *formattedString;
-  asprintf(&formattedString, "%s", get_board_state_string(remoteStats.state));
-
-  // First time initialization
-  if (last_board_state_string == NULL) {
-    last_board_state_string = strdup(formattedString);
-    lv_label_set_text(ui_MessageText, formattedString);
-    free(formattedString);
-    return;
-  }
-
-  // Compare and update if different
-  if (strcmp(last_board_state_string, formattedString) != 0) {
-    free(last_board_state_string);
-    last_board_state_string = strdup(formattedString);
-    lv_label_set_text(ui_MessageText, formattedString);
-  }
-
-  free(formattedString);
+  // Strings are literals so the label can reference them without copying
+  lv_label_set_text_static(ui_MessageText, get_board_state_string(stats.state));
 }
 
-static void update_header_display() {
+static void update_header_display(StatsFieldMask mask) {
   static bool last_should_show_board_state = false;
   bool should_show_board_state =
       connection_state == CONNECTION_STATE_CONNECTED &&
-      (remoteStats.state == BOARD_STATE_RUNNING_FLYWHEEL || remoteStats.state == BOARD_STATE_RUNNING_TILTBACK ||
-       remoteStats.state == BOARD_STATE_RUNNING_UPSIDEDOWN || remoteStats.state == BOARD_STATE_RUNNING_WHEELSLIP);
+      (stats.state == BOARD_STATE_RUNNING_FLYWHEEL || stats.state == BOARD_STATE_RUNNING_TILTBACK ||
+       stats.state == BOARD_STATE_RUNNING_UPSIDEDOWN || stats.state == BOARD_STATE_RUNNING_WHEELSLIP);
 
   if (should_show_board_state != last_should_show_board_state) {
     if (should_show_board_state) {
@@ -260,79 +230,63 @@ static void update_header_display() {
       lv_obj_add_flag(ui_MessageText, LV_OBJ_FLAG_HIDDEN);
       lv_obj_clear_flag(ui_RemoteIndicatorContainer, LV_OBJ_FLAG_HIDDEN);
     }
+
+    // Widgets that were hidden missed any updates in the meantime
+    mask = STATS_FIELD_ALL;
   }
 
   if (should_show_board_state) {
-    update_board_state_text();
+    if (mask & STATS_FIELD_STATE) {
+      update_board_state_text();
+    }
   }
   else {
-    update_remote_battery_display();
-    update_rssi_display();
-    update_pocket_mode_display();
+    if (mask & STATS_FIELD_REMOTE_BATTERY) {
+      update_remote_battery_display();
+    }
+
+    if (mask & (STATS_FIELD_SIGNAL | STATS_FIELD_CONNECTION)) {
+      update_rssi_display();
+    }
+
+    update_remote_mode_display();
   }
 
   last_should_show_board_state = should_show_board_state;
 }
 
 static void update_duty_cycle_display() {
-  static float last_value = 0;
-
-  // Ensure the value has changed
-  if (last_value == remoteStats.dutyCycle) {
-    return;
-  }
-
   // Update the displayed text
-  char *formattedString;
-  asprintf(&formattedString, "Duty Cycle: %d%%", remoteStats.dutyCycle);
-  lv_label_set_text(ui_DutyCycleLabel, formattedString);
-  free(formattedString);
-
-  // Update the last value
-  last_value = remoteStats.dutyCycle;
+  static char duty_cycle_text[STATS_LABEL_BUFFER_SIZE];
+  snprintf(duty_cycle_text, sizeof(duty_cycle_text), "Duty Cycle: %d%%", stats.dutyCycle);
+  lv_label_set_text_static(ui_DutyCycleLabel, duty_cycle_text);
 }
 
 static void update_temps_display() {
-  static float last_motor_temp_value = 0.0;
-  static float last_controller_temp_value = 0.0;
-
-  // Ensure the value has changed
-  if (last_motor_temp_value == remoteStats.motorTemp && last_controller_temp_value == remoteStats.controllerTemp) {
-    return;
-  }
-
   bool should_convert = device_settings.temp_units == TEMP_UNITS_FAHRENHEIT;
-  float converted_mot_val = remoteStats.motorTemp;
-  float converted_cont_val = remoteStats.controllerTemp;
+  float converted_mot_val = stats.motorTemp;
+  float converted_cont_val = stats.controllerTemp;
   char temp_unit_label[] = CELSIUS_LABEL;
 
   if (should_convert) {
-    converted_mot_val = convert_c_to_f(remoteStats.motorTemp);
-    converted_cont_val = convert_c_to_f(remoteStats.controllerTemp);
+    converted_mot_val = convert_c_to_f(stats.motorTemp);
+    converted_cont_val = convert_c_to_f(stats.controllerTemp);
     strncpy(temp_unit_label, FAHRENHEIT_LABEL, sizeof(temp_unit_label) - 1);
   }
 
   // Update the displayed text
-  char *formattedString;
-  asprintf(&formattedString, "M: %.0f°%s | C: %.0f°%s", converted_mot_val, temp_unit_label, converted_cont_val,
+  static char temps_text[STATS_LABEL_BUFFER_SIZE];
+  char motor_temp[FORMAT_NUMBER_BUFFER_SIZE];
+  char controller_temp[FORMAT_NUMBER_BUFFER_SIZE];
+  format_fixed(motor_temp, sizeof(motor_temp), converted_mot_val, 0);
+  format_fixed(controller_temp, sizeof(controller_temp), converted_cont_val, 0);
+  snprintf(temps_text, sizeof(temps_text), "M: %s°%s | C: %s°%s", motor_temp, temp_unit_label, controller_temp,
            temp_unit_label);
-  lv_label_set_text(ui_TempsLabel, formattedString);
-  free(formattedString);
-
-  // Update the last value
-  last_motor_temp_value = remoteStats.motorTemp;
-  last_controller_temp_value = remoteStats.controllerTemp;
+  lv_label_set_text_static(ui_TempsLabel, temps_text);
 }
 
 static void update_trip_distance_display() {
-  static float last_trip_distance_value = -1; // Set to -1 to force initial update
-  float new_trip_distance = remoteStats.tripDistance / 1000.0;
-
-  // Ensure the value has changed
-  if (last_trip_distance_value == new_trip_distance) {
-    return;
-  }
-
+  float new_trip_distance = stats.tripDistance / 1000.0;
   float converted_val = new_trip_distance;
 
   if (device_settings.distance_units == DISTANCE_UNITS_IMPERIAL) {
@@ -346,13 +300,11 @@ static void update_trip_distance_display() {
   }
 
   // Update the displayed text
-  char *formattedString;
-  asprintf(&formattedString, "Trip: %.1f%s", converted_val, distance_label);
-  lv_label_set_text(ui_TripLabel, formattedString);
-  free(formattedString);
-
-  // Update the last value
-  last_trip_distance_value = new_trip_distance;
+  static char trip_text[STATS_LABEL_BUFFER_SIZE];
+  char trip_distance[FORMAT_NUMBER_BUFFER_SIZE];
+  format_fixed(trip_distance, sizeof(trip_distance), converted_val, 1);
+  snprintf(trip_text, sizeof(trip_text), "Trip: %s%s", trip_distance, distance_label);
+  lv_label_set_text_static(ui_TripLabel, trip_text);
 }
 
 static char *get_connection_state_label() {
@@ -370,7 +322,7 @@ static char *get_connection_state_label() {
   }
 }
 
-static void update_secondary_stat_display() {
+static void update_secondary_stat_display(StatsFieldMask mask) {
   static ConnectionState last_connection_state = CONNECTION_STATE_DISCONNECTED;
   static lv_coord_t connected_scroll_position = 0;
   ConnectionState new_connection_state = connection_state;
@@ -398,13 +350,24 @@ static void update_secondary_stat_display() {
     }
 
     lv_label_set_text(ui_ConnectionStateLabel, get_connection_state_label());
+
+    // Labels are not refreshed while hidden
+    mask = STATS_FIELD_ALL;
   }
 
   // Update secondary stat displays if currently connected
   if (connection_state == CONNECTION_STATE_CONNECTED) {
-    update_duty_cycle_display();
-    update_temps_display();
-    update_trip_distance_display();
+    if (mask & STATS_FIELD_DUTY_CYCLE) {
+      update_duty_cycle_display();
+    }
+
+    if (mask & (STATS_FIELD_TEMPS | STATS_FIELD_UNITS)) {
+      update_temps_display();
+    }
+
+    if (mask & (STATS_FIELD_TRIP_DISTANCE | STATS_FIELD_UNITS)) {
+      update_trip_distance_display();
+    }
   }
 
   // Update the last value
@@ -414,34 +377,36 @@ static void update_secondary_stat_display() {
 static void update_board_battery_display() {
   static float last_board_battery_voltage = 0;
   static BoardBatteryDisplayOption last_units = 0;
-  char *formattedString;
+  static char board_battery_text[STATS_LABEL_BUFFER_SIZE];
+  char voltage[FORMAT_NUMBER_BUFFER_SIZE];
 
   // Ensure the value has changed
-  if (fabsf(last_board_battery_voltage - remoteStats.batteryVoltage) < 0.1f &&
+  if (fabsf(last_board_battery_voltage - stats.batteryVoltage) < 0.1f &&
       device_settings.battery_display == last_units) {
     return;
   }
 
+  format_fixed(voltage, sizeof(voltage), stats.batteryVoltage, 1);
+
   switch (device_settings.battery_display) {
   case BATTERY_DISPLAY_PERCENT:
     // Update the displayed text
-    asprintf(&formattedString, "%d%%", remoteStats.batteryPercentage);
+    snprintf(board_battery_text, sizeof(board_battery_text), "%d%%", stats.batteryPercentage);
     break;
   case BATTERY_DISPLAY_VOLTAGE:
     // Update the displayed text
-    asprintf(&formattedString, "%.1fV", remoteStats.batteryVoltage);
+    snprintf(board_battery_text, sizeof(board_battery_text), "%sV", voltage);
     break;
   case BATTERY_DISPLAY_ALL:
     // Update the displayed text
-    asprintf(&formattedString, "%d%% | %.1fV", remoteStats.batteryPercentage, remoteStats.batteryVoltage);
+    snprintf(board_battery_text, sizeof(board_battery_text), "%d%% | %sV", stats.batteryPercentage, voltage);
     break;
   }
 
-  lv_label_set_text(ui_BoardBatteryDisplay, formattedString);
-  free(formattedString);
+  lv_label_set_text_static(ui_BoardBatteryDisplay, board_battery_text);
 
   // Update the last values
-  last_board_battery_voltage = remoteStats.batteryVoltage;
+  last_board_battery_voltage = stats.batteryVoltage;
   last_units = device_settings.battery_display;
 }
 
@@ -462,14 +427,7 @@ static void change_board_battery_display() {
 }
 
 static void update_footpad_display() {
-  static SwitchState last_value = SWITCH_STATE_OFF;
-
-  // Ensure the value has changed
-  if (last_value == remoteStats.switchState) {
-    return;
-  }
-
-  switch (remoteStats.switchState) {
+  switch (stats.switchState) {
   case SWITCH_STATE_OFF:
     lv_arc_set_value(ui_LeftSensor, 0);
     lv_arc_set_value(ui_RightSensor, 0);
@@ -489,31 +447,51 @@ static void update_footpad_display() {
   default:
     break;
   }
-
-  last_value = remoteStats.switchState;
 }
 
-static void stats_update_screen_display() {
+static void update_stats_display(StatsFieldMask mask) {
+  stats_read_snapshot(&stats);
+
   if (LVGL_lock(LV_DISP_DEF_REFR_PERIOD)) {
-    if (device_settings.distance_units == DISTANCE_UNITS_METRIC) {
-      lv_label_set_text(ui_PrimaryStatUnit, KILOMETERS_PER_HOUR_LABEL);
+    if (mask & STATS_FIELD_UNITS) {
+      if (device_settings.distance_units == DISTANCE_UNITS_METRIC) {
+        lv_label_set_text_static(ui_PrimaryStatUnit, KILOMETERS_PER_HOUR_LABEL);
+      }
+      else {
+        lv_label_set_text_static(ui_PrimaryStatUnit, MILES_PER_HOUR_LABEL);
+      }
     }
-    else {
-      lv_label_set_text(ui_PrimaryStatUnit, MILES_PER_HOUR_LABEL);
+
+    if (mask & (STATS_FIELD_SPEED | STATS_FIELD_UNITS)) {
+      update_speed_dial_display();
+      update_primary_stat_display();
+    }
+
+    if (mask & STATS_FIELD_DUTY_CYCLE) {
+      update_utilization_dial_display();
+    }
+
+    if (mask & STATS_FIELD_BATTERY) {
+      update_board_battery_display();
+    }
+
+    if (mask & STATS_FIELD_SWITCH) {
+      update_footpad_display();
     }
 
-    update_speed_dial_display();
-    update_utilization_dial_display();
-    update_header_display();
-    update_primary_stat_display();
-    update_secondary_stat_display();
-    update_board_battery_display();
-    update_footpad_display();
+    // Header mixes board state, remote battery and signal strength
+    update_header_display(mask);
+    update_secondary_stat_display(mask);
 
     LVGL_unlock();
   }
 }
 
+// Called from the LVGL task at most once per refresh period with the coalesced set of changes
+static void stats_update_screen_display() {
+  update_stats_display(stats_get_update_mask());
+}
+
 // Event handlers
 void stats_screen_load_start(lv_event_t *e) {
   ESP_LOGI(TAG, "Stats screen load start");
@@ -556,7 +534,7 @@ static bool double_press_handler() {
 
 void stats_screen_loaded(lv_event_t *e) {
   ESP_LOGI(TAG, "Stats screen loaded");
-  stats_update_screen_display();
+  update_stats_display(STATS_FIELD_ALL);
   register_primary_button_cb(BUTTON_EVENT_DOUBLE_PRESS, double_press_handler);
 
   if (LVGL_lock(-1)) {
@@ -164,7 +164,7 @@ static void simple_progress_callback(const char *status) {
 }
 
 static void update_task(void *pvParameters) {
-  connection_update_state(CONNECTION_STATE_DISCONNECTED);
+  connection_disconnect();
   if (espnow_is_initialized()) {
     espnow_deinit();
   }
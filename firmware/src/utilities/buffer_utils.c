@@ -0,0 +1,24 @@
+#include "buffer_utils.h"
+
+// Shifts are done on unsigned values so bytes >= 0x80 never shift into the sign bit of an int
+
+uint16_t buffer_get_uint16(const uint8_t *buffer, int32_t *index) {
+  uint16_t value = ((uint16_t)buffer[*index] << 8) | (uint16_t)buffer[*index + 1];
+  *index += 2;
+  return value;
+}
+
+int16_t buffer_get_int16(const uint8_t *buffer, int32_t *index) {
+  return (int16_t)buffer_get_uint16(buffer, index);
+}
+
+uint32_t buffer_get_uint32(const uint8_t *buffer, int32_t *index) {
+  uint32_t value = ((uint32_t)buffer[*index] << 24) | ((uint32_t)buffer[*index + 1] << 16) |
+                   ((uint32_t)buffer[*index + 2] << 8) | (uint32_t)buffer[*index + 3];
+  *index += 4;
+  return value;
+}
+
+int32_t buffer_get_int32(const uint8_t *buffer, int32_t *index) {
+  return (int32_t)buffer_get_uint32(buffer, index);
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef __BUFFER_UTILS_H
+#define __BUFFER_UTILS_H
+#include <stdint.h>
+#include <stdio.h>
+
+// Big endian readers for radio payloads. Each reads at buffer[*index] and advances index, callers are expected to have
+// validated the payload length first.
+int16_t buffer_get_int16(const uint8_t *buffer, int32_t *index);
+uint16_t buffer_get_uint16(const uint8_t *buffer, int32_t *index);
+int32_t buffer_get_int32(const uint8_t *buffer, int32_t *index);
+uint32_t buffer_get_uint32(const uint8_t *buffer, int32_t *index);
+
+#endif
@@ -0,0 +1,91 @@
+#include "format_utils.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Formatting helpers that write into caller owned buffers without touching the heap or pulling in float printf
+
+#define FORMAT_MAX_DECIMALS 3
+
+static const int32_t decimal_scale[FORMAT_MAX_DECIMALS + 1] = {1, 10, 100, 1000};
+
+/*
+ * Write an unsigned value into buf, zero padded to min_digits
+ * @return The number of characters written, excluding the terminator
+ */
+static size_t write_digits(char *buf, size_t size, uint32_t value, uint8_t min_digits) {
+  char digits[10];
+  uint8_t count = 0;
+
+  do {
+    digits[count++] = '0' + (value % 10);
+    value /= 10;
+  } while (value > 0 && count < sizeof(digits));
+
+  while (count < min_digits && count < sizeof(digits)) {
+    digits[count++] = '0';
+  }
+
+  size_t written = 0;
+  while (count > 0 && written + 1 < size) {
+    buf[written++] = digits[--count];
+  }
+
+  if (size > 0) {
+    buf[written] = '\0';
+  }
+
+  return written;
+}
+
+/*
+ * Format a value with a fixed number of decimals (max 3), rounded half away from zero
+ * e.g. format_fixed(buf, sizeof(buf), 12.34f, 1) writes "12.3"
+ * @return The number of characters written, excluding the terminator
+ */
+size_t format_fixed(char *buf, size_t size, float value, uint8_t decimals) {
+  if (buf == NULL || size == 0) {
+    return 0;
+  }
+
+  if (decimals > FORMAT_MAX_DECIMALS) {
+    decimals = FORMAT_MAX_DECIMALS;
+  }
+
+  // Work in integer fixed point from here on
+  int32_t scale = decimal_scale[decimals];
+  float scaled_value = roundf(value * scale);
+
+  // INT32_MAX is not representable as a float and rounds up to 2^31, so compare against 2^31 directly
+  // and clamp in the integer domain, the float to int conversion is undefined outside the int32 range
+  int32_t fixed;
+  if (isnan(scaled_value)) {
+    fixed = 0;
+  }
+  else if (scaled_value >= 2147483648.0f) {
+    fixed = INT32_MAX;
+  }
+  else if (scaled_value <= -2147483648.0f) {
+    fixed = -INT32_MAX;
+  }
+  else {
+    fixed = (int32_t)scaled_value;
+  }
+
+  bool negative = fixed < 0;
+  uint32_t magnitude = negative ? -(uint32_t)fixed : (uint32_t)fixed;
+  size_t written = 0;
+
+  if (negative && size > 1) {
+    buf[written++] = '-';
+  }
+
+  written += write_digits(buf + written, size - written, magnitude / scale, 1);
+
+  if (decimals > 0 && written + 1 < size) {
+    buf[written++] = '.';
+    written += write_digits(buf + written, size - written, magnitude % scale, decimals);
+  }
+
+  return written;
+}
@@ -0,0 +1,11 @@
+#ifndef __FORMAT_UTILS_H
+#define __FORMAT_UTILS_H
+#include <stdint.h>
+#include <stdio.h>
+
+// Large enough for any int32 value with sign, decimal point and terminator
+#define FORMAT_NUMBER_BUFFER_SIZE 16
+
+size_t format_fixed(char *buf, size_t size, float value, uint8_t decimals);
+
+#endif
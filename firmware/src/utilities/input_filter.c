@@ -0,0 +1,48 @@
+#include "input_filter.h"
+
+// Rejects single sample spikes that an average would smear into the output
+uint16_t median_u16(const uint16_t *samples, uint8_t count) {
+  if (count == 0) {
+    return 0;
+  }
+
+  if (count > MEDIAN_MAX_SAMPLES) {
+    count = MEDIAN_MAX_SAMPLES;
+  }
+
+  // Insertion sort, count is small
+  uint16_t sorted[MEDIAN_MAX_SAMPLES];
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t sample = samples[i];
+    uint8_t j = i;
+    while (j > 0 && sorted[j - 1] > sample) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = sample;
+  }
+
+  // Average the middle pair for even counts
+  return count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2] + 1) / 2;
+}
+
+void iir_filter_init(IirFilter *filter, uint8_t shift) {
+  filter->value = 0;
+  filter->shift = shift;
+  filter->is_primed = false;
+}
+
+uint16_t iir_filter_update(IirFilter *filter, uint16_t sample) {
+  int32_t scaled = (int32_t)sample << 8;
+
+  if (!filter->is_primed) {
+    // Start at the first sample rather than ramping up from 0
+    filter->value = scaled;
+    filter->is_primed = true;
+  }
+  else {
+    filter->value += (scaled - filter->value) >> filter->shift;
+  }
+
+  return (filter->value + (1 << 7)) >> 8;
+}
\ No newline at end of file
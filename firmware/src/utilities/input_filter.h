@@ -0,0 +1,20 @@
+#ifndef __INPUT_FILTER_H
+#define __INPUT_FILTER_H
+#include <stdbool.h>
+#include <stdint.h>
+
+// Most samples that can go through median_u16 at once
+#define MEDIAN_MAX_SAMPLES 16
+
+// First order low pass in fixed point: value += (sample - value) / 2^shift. Shift 0 passes samples through.
+typedef struct {
+  int32_t value; // Scaled by 2^8 to keep fractions between samples
+  uint8_t shift;
+  bool is_primed;
+} IirFilter;
+
+uint16_t median_u16(const uint16_t *samples, uint8_t count);
+void iir_filter_init(IirFilter *filter, uint8_t shift);
+uint16_t iir_filter_update(IirFilter *filter, uint16_t sample);
+
+#endif
@@ -0,0 +1,63 @@
+#include "remote/receiver.c"
+#include "fakes.h"
+#include <sanitizer/asan_interface.h>
+#include <stdlib.h>
+
+// Fuzz target over the command descriptor table. Input layout: [context u8][frame...], the frame is what ESP-NOW hands
+// to the receive callback, starting with the command byte. The context byte picks the remote state the frame meets:
+//   bits 0-1 pairing state, bits 2-3 connection state, bit 4 pairing screen shown, bit 5 sent by the paired board,
+//   bit 6 group mode enabled
+#define CONTEXT_SIZE 1
+
+static const uint8_t paired_mac[ESP_NOW_ETH_ALEN] = {0x84, 0xFC, 0xE6, 0x50, 0xA8, 0x0C};
+static const uint8_t other_mac[ESP_NOW_ETH_ALEN] = {0x84, 0xFC, 0xE6, 0x50, 0xA8, 0x0D};
+static bool is_group_enabled = false;
+
+bool group_is_enabled() {
+  return is_group_enabled;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (size < CONTEXT_SIZE + 1 || size - CONTEXT_SIZE > FRAME_POOL_SLOT_SIZE) {
+    return 0;
+  }
+
+  uint8_t context = data[0];
+
+  // Every input starts from the same remote, so a crash reproduces from its input alone
+  frame_pool_init();
+  telemetry_reset();
+  link_stats_reset_rx_sequence();
+  memset(&pairing_settings, 0, sizeof(pairing_settings));
+  memcpy(pairing_settings.remote_addr, paired_mac, ESP_NOW_ETH_ALEN);
+  pairing_settings.secret_code = 0x12345678;
+  pairing_state = context & 0x03;
+  connection_state = (context >> 2) & 0x03;
+  fake_pairing_screen_active = context & 0x10;
+  is_group_enabled = context & 0x40;
+
+  esp_now_event_t evt = {
+      .slot = frame_pool_acquire(),
+      .len = size - CONTEXT_SIZE,
+      .chan = 1,
+      .rssi = -60,
+      .rx_time_us = fake_time_us,
+  };
+  memcpy(evt.mac_addr, (context & 0x20) ? paired_mac : other_mac, ESP_NOW_ETH_ALEN);
+
+  // Poison the rest of the slot so the sanitizer reports any read past the end of the frame
+  uint8_t *slot_data = frame_pool_data(evt.slot);
+  memcpy(slot_data, data + CONTEXT_SIZE, evt.len);
+  ASAN_POISON_MEMORY_REGION(slot_data + evt.len, FRAME_POOL_SLOT_SIZE - evt.len);
+
+  process_data(evt);
+  ASAN_UNPOISON_MEMORY_REGION(slot_data, FRAME_POOL_SLOT_SIZE);
+  release_event(&evt);
+
+  if (frame_pool_in_use() != 0) {
+    abort();
+  }
+
+  fake_time_us += 20000;
+  return 0;
+}
@@ -0,0 +1 @@
+#include "remote/commands.c"
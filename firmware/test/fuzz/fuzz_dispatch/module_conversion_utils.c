@@ -0,0 +1 @@
+#include "utilities/conversion_utils.c"
@@ -0,0 +1,75 @@
+// Standalone driver for compilers without libFuzzer, e.g. gcc with sanitizers. Replays every file given on the command
+// line, directories are replayed file by file, so a corpus can be checked without a fuzzing engine.
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static int replay_file(const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) {
+    perror(path);
+    return 1;
+  }
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  uint8_t *data = malloc(size > 0 ? size : 1);
+  size_t read = fread(data, 1, size, file);
+  fclose(file);
+
+  LLVMFuzzerTestOneInput(data, read);
+  free(data);
+  return 0;
+}
+
+static int replay_path(const char *path, int *count) {
+  struct stat info;
+  if (stat(path, &info) != 0) {
+    perror(path);
+    return 1;
+  }
+
+  if (!S_ISDIR(info.st_mode)) {
+    (*count)++;
+    return replay_file(path);
+  }
+
+  DIR *dir = opendir(path);
+  if (dir == NULL) {
+    perror(path);
+    return 1;
+  }
+
+  int failures = 0;
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+
+    char child[1024];
+    snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+    failures += replay_path(child, count);
+  }
+
+  closedir(dir);
+  return failures;
+}
+
+int main(int argc, char **argv) {
+  int failures = 0;
+  int count = 0;
+
+  for (int i = 1; i < argc; i++) {
+    failures += replay_path(argv[i], &count);
+  }
+
+  printf("Replayed %d inputs\n", count);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+#include "remote/commands.c"
+#include "fakes.h"
+#include "remote/link_stats.h"
+#include "remote/pairing.h"
+#include "remote/telemetry.h"
+#include <stdlib.h>
+
+// Fuzz target calling the payload parsers directly, below the length checks of the command dispatch. Input layout:
+// [parser u8][records...], each record is [length u8][payload] and is handed to the parser in its own allocation of
+// exactly that length, so the sanitizer catches any read past the payload. Records follow each other through the same
+// state, e.g. telemetry deltas are decoded against an earlier keyframe of the same input.
+typedef enum {
+  FUZZ_PARSER_BOARD_DATA,
+  FUZZ_PARSER_TELEMETRY,
+  FUZZ_PARSER_PAIRING,
+  FUZZ_PARSER_COUNT
+} FuzzParser;
+
+static const uint8_t board_mac[ESP_NOW_ETH_ALEN] = {0x84, 0xFC, 0xE6, 0x50, 0xA8, 0x0C};
+
+static void parse_record(FuzzParser parser, uint8_t *payload, int len) {
+  TelemetryData telemetry;
+
+  switch (parser) {
+  case FUZZ_PARSER_BOARD_DATA:
+    decode_board_data(payload, len, &telemetry);
+    break;
+  case FUZZ_PARSER_TELEMETRY: {
+    uint8_t sequence;
+    telemetry_decode(payload, len, &sequence, &telemetry);
+    break;
+  }
+  case FUZZ_PARSER_PAIRING: {
+    // Walk the pairing handshake, each record goes to the step the current pairing state expects
+    esp_now_event_t evt = {.chan = 1, .rssi = -60};
+    memcpy(evt.mac_addr, board_mac, ESP_NOW_ETH_ALEN);
+
+    if (pairing_state == PAIRING_STATE_UNPAIRED) {
+      pairing_process_init_event(payload, len, evt);
+    }
+    else if (pairing_state == PAIRING_STATE_PAIRING) {
+      pairing_process_bond_event(payload, len);
+    }
+    else {
+      pairing_process_completion_event(payload, len);
+    }
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (size < 1) {
+    return 0;
+  }
+
+  FuzzParser parser = data[0] % FUZZ_PARSER_COUNT;
+
+  telemetry_reset();
+  link_stats_reset_rx_sequence();
+  memset(&pairing_settings, 0, sizeof(pairing_settings));
+  pairing_state = PAIRING_STATE_UNPAIRED;
+
+  size_t ind = 1;
+  while (ind < size) {
+    int len = data[ind++];
+    if (len > size - ind) {
+      len = size - ind;
+    }
+
+    uint8_t *payload = malloc(len > 0 ? len : 1);
+    memcpy(payload, data + ind, len);
+    parse_record(parser, payload, len);
+    free(payload);
+
+    ind += len;
+    fake_time_us += 20000;
+  }
+
+  return 0;
+}
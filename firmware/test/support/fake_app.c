@@ -0,0 +1,188 @@
+#include "fakes.h"
+#include "remote/channel_planner.h"
+#include "remote/connection.h"
+#include "remote/display.h"
+#include "remote/espnow.h"
+#include "remote/group.h"
+#include "remote/link_health.h"
+#include "remote/link_stats.h"
+#include "remote/peer_manager.h"
+#include "remote/peers.h"
+#include "remote/powermanagement.h"
+#include "remote/receiver.h"
+#include "remote/settings.h"
+#include "remote/stats.h"
+#include "remote/telemetry.h"
+#include "remote/time.h"
+#include "remote/transmitter.h"
+#include "screens/pairing_screen.h"
+#include "screens/stats_screen.h"
+#include <string.h>
+
+// State owned by modules that are not under test
+FAKE ConnectionState connection_state = CONNECTION_STATE_DISCONNECTED;
+FAKE PairingState pairing_state = PAIRING_STATE_UNPAIRED;
+FAKE PairingSettings pairing_settings = {};
+FAKE DeviceSettings device_settings = {};
+FAKE CalibrationSettings calibration_settings = {};
+FAKE lv_obj_t *ui_PairingCode = NULL;
+FAKE lv_obj_t *ui_StatsScreen = NULL;
+bool fake_pairing_screen_active = false;
+bool fake_stats_screen_active = true;
+
+// Stats without the seqlock, suites read fake_stats directly
+RemoteStats fake_stats = {};
+
+FAKE void stats_init() {
+  memset(&fake_stats, 0, sizeof(fake_stats));
+}
+
+FAKE RemoteStats *stats_begin_update() {
+  return &fake_stats;
+}
+
+FAKE void stats_publish() {}
+
+FAKE void stats_update(StatsFieldMask mask) {}
+
+FAKE void stats_read_snapshot(RemoteStats *out) {
+  *out = fake_stats;
+}
+
+FAKE int64_t get_current_time_ms() {
+  return fake_time_us / 1000;
+}
+
+FAKE bool is_same_mac(const uint8_t *mac1, const uint8_t *mac2) {
+  return memcmp(mac1, mac2, ESP_NOW_ETH_ALEN) == 0;
+}
+
+FAKE void connection_notify_frame() {}
+
+FAKE void connection_disconnect() {}
+
+FAKE void connection_connect_to_peer(uint8_t *mac_addr, uint8_t channel) {}
+
+FAKE void connection_connect_to_default_peer() {}
+
+FAKE void reset_sleep_timer() {}
+
+FAKE bool is_pairing_screen_active() {
+  return fake_pairing_screen_active;
+}
+
+FAKE bool is_stats_screen_active() {
+  return fake_stats_screen_active;
+}
+
+FAKE bool is_pocket_mode_enabled() {
+  return false;
+}
+
+FAKE bool LVGL_lock(int timeout_ms) {
+  return true;
+}
+
+FAKE void LVGL_unlock() {}
+
+FAKE lv_timer_t *lv_timer_create(lv_timer_cb_t timer_cb, uint32_t period, void *user_data) {
+  return NULL;
+}
+
+FAKE void lv_label_set_text(lv_obj_t *obj, const char *text) {}
+
+FAKE void lv_disp_load_scr(lv_obj_t *scr) {}
+
+FAKE esp_err_t save_pairing_data() {
+  return ESP_OK;
+}
+
+FAKE esp_err_t nvs_write_blob(const char *key, void *value, size_t length) {
+  return ESP_OK;
+}
+
+FAKE esp_err_t nvs_read_blob(const char *key, void *value, size_t length) {
+  return ESP_ERR_NVS_NOT_FOUND;
+}
+
+FAKE bool group_is_enabled() {
+  return false;
+}
+
+FAKE bool group_process_data(const uint8_t *mac_addr, int rssi, uint8_t channel, const uint8_t *data, int len) {
+  return false;
+}
+
+FAKE void group_send_input_state(const RemoteData *data) {}
+
+FAKE void group_record_delivery(const uint8_t *mac_addr, bool is_delivered) {}
+
+FAKE uint8_t group_get_member_count() {
+  return 0;
+}
+
+FAKE void peers_save_active() {}
+
+FAKE bool peers_try_switch(const uint8_t *mac_addr, uint32_t secret_code, uint8_t channel) {
+  return false;
+}
+
+FAKE esp_err_t peer_manager_set_peer(const uint8_t *mac_addr, uint8_t channel) {
+  return ESP_OK;
+}
+
+FAKE esp_err_t peer_manager_set_encryption(bool is_enabled) {
+  return ESP_OK;
+}
+
+FAKE bool peer_manager_is_encrypted() {
+  return false;
+}
+
+FAKE uint8_t peer_manager_get_channel() {
+  return 1;
+}
+
+FAKE bool receiver_lock_channel() {
+  return true;
+}
+
+FAKE void receiver_unlock_channel() {}
+
+FAKE void transmitter_set_receiver_capabilities(uint8_t capabilities) {}
+
+FAKE void transmitter_notify_input_changed() {}
+
+FAKE void channel_planner_init() {}
+
+FAKE void channel_planner_start(uint8_t last_good_channel, bool is_reconnecting) {}
+
+FAKE uint8_t channel_planner_next() {
+  return 1;
+}
+
+FAKE uint32_t channel_planner_get_dwell_ms() {
+  return 200;
+}
+
+FAKE void channel_planner_record_success(uint8_t channel, int rssi) {}
+
+FAKE void link_health_reset() {}
+
+FAKE void link_health_record_rx(int rssi, int64_t rx_time_us) {}
+
+FAKE void link_health_record_tx(bool is_delivered) {}
+
+FAKE LinkHealth link_health_assess(int64_t now_us) {
+  return LINK_HEALTH_GOOD;
+}
+
+FAKE void link_stats_record_rx(int rssi, int64_t rx_time_us) {}
+
+FAKE bool link_stats_record_rx_sequence(uint8_t sequence) {
+  return true;
+}
+
+FAKE void link_stats_reset_rx_sequence() {}
+
+FAKE void telemetry_reset() {}
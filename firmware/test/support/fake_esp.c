@@ -0,0 +1,66 @@
+#include "fakes.h"
+#include <esp_now.h>
+#include <esp_timer.h>
+#include <esp_wifi.h>
+#include <iot_button.h>
+
+int64_t fake_time_us = 0;
+
+FAKE int64_t esp_timer_get_time(void) {
+  return fake_time_us;
+}
+
+FAKE esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle) {
+  *handle = NULL;
+  return ESP_OK;
+}
+
+FAKE esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+  return ESP_OK;
+}
+
+FAKE esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  return ESP_OK;
+}
+
+FAKE esp_err_t esp_now_send(const uint8_t *peer_addr, const uint8_t *data, size_t len) {
+  return ESP_OK;
+}
+
+FAKE esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb) {
+  return ESP_OK;
+}
+
+FAKE esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb) {
+  return ESP_OK;
+}
+
+FAKE esp_err_t esp_now_add_peer(const esp_now_peer_info_t *peer) {
+  return ESP_OK;
+}
+
+FAKE esp_err_t esp_now_mod_peer(const esp_now_peer_info_t *peer) {
+  return ESP_OK;
+}
+
+FAKE esp_err_t esp_now_del_peer(const uint8_t *peer_addr) {
+  return ESP_OK;
+}
+
+FAKE bool esp_now_is_peer_exist(const uint8_t *peer_addr) {
+  return false;
+}
+
+FAKE esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second) {
+  return ESP_OK;
+}
+
+FAKE esp_err_t esp_wifi_get_channel(uint8_t *primary, wifi_second_chan_t *second) {
+  *primary = 1;
+  *second = WIFI_SECOND_CHAN_NONE;
+  return ESP_OK;
+}
+
+FAKE esp_err_t iot_button_delete(button_handle_t btn_handle) {
+  return ESP_OK;
+}
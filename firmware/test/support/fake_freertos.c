@@ -0,0 +1,102 @@
+#include "fakes.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct QueueDefinition {
+  uint8_t *items;
+  UBaseType_t length;
+  UBaseType_t item_size;
+  UBaseType_t head;
+  UBaseType_t count;
+};
+
+FAKE QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+  QueueHandle_t queue = calloc(1, sizeof(*queue));
+  queue->items = calloc(length, item_size);
+  queue->length = length;
+  queue->item_size = item_size;
+  return queue;
+}
+
+FAKE void vQueueDelete(QueueHandle_t queue) {
+  free(queue->items);
+  free(queue);
+}
+
+FAKE BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks) {
+  if (queue->count == queue->length) {
+    return pdFALSE;
+  }
+
+  UBaseType_t tail = (queue->head + queue->count) % queue->length;
+  memcpy(queue->items + tail * queue->item_size, item, queue->item_size);
+  queue->count++;
+  return pdTRUE;
+}
+
+FAKE BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks) {
+  if (queue->count == 0) {
+    return pdFALSE;
+  }
+
+  memcpy(item, queue->items + queue->head * queue->item_size, queue->item_size);
+  queue->head = (queue->head + 1) % queue->length;
+  queue->count--;
+  return pdTRUE;
+}
+
+FAKE BaseType_t xQueueReset(QueueHandle_t queue) {
+  queue->head = 0;
+  queue->count = 0;
+  return pdPASS;
+}
+
+FAKE UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+  return queue->length - queue->count;
+}
+
+FAKE UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  return queue->count;
+}
+
+// Mutexes are only contended across tasks, suites drive one task at a time
+FAKE SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  return xQueueCreate(1, 1);
+}
+
+FAKE BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+  return pdTRUE;
+}
+
+FAKE BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  return pdTRUE;
+}
+
+FAKE BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stack_depth, void *params,
+                                        UBaseType_t priority, TaskHandle_t *handle, BaseType_t core_id) {
+  return pdPASS;
+}
+
+FAKE void vTaskDelete(TaskHandle_t task) {}
+
+FAKE void vTaskDelay(TickType_t ticks) {}
+
+FAKE BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+  return pdPASS;
+}
+
+FAKE BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks) {
+  return pdFALSE;
+}
+
+FAKE BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  return pdPASS;
+}
+
+FAKE uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+  return 0;
+}
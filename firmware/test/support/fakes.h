@@ -0,0 +1,19 @@
+#ifndef __FAKES_H
+#define __FAKES_H
+#include "remote/stats.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Host fakes for the platform and for firmware modules a suite does not test. Every fake is weak, so a suite that
+// compiles the real module gets the real one.
+#define FAKE __attribute__((weak))
+
+// Clock behind esp_timer_get_time and get_current_time_ms, advanced by the suite
+extern int64_t fake_time_us;
+// Return values of is_pairing_screen_active and is_stats_screen_active
+extern bool fake_pairing_screen_active;
+extern bool fake_stats_screen_active;
+// Backing store of the stats fakes
+extern RemoteStats fake_stats;
+
+#endif
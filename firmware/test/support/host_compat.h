@@ -0,0 +1,11 @@
+#ifndef __HOST_COMPAT_H
+#define __HOST_COMPAT_H
+
+// Included ahead of every host source. Newlib and the ESP-IDF headers bring these in indirectly (stdio.h alone
+// provides the fixed width types), so firmware sources rely on them without including them.
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#endif
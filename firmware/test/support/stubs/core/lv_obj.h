@@ -0,0 +1,5 @@
+#ifndef __LV_OBJ_H
+#define __LV_OBJ_H
+#include "lvgl.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef __DRIVER_GPIO_H
+#define __DRIVER_GPIO_H
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef __ADC_CALI_H
+#define __ADC_CALI_H
+
+typedef struct adc_cali_scheme_t *adc_cali_handle_t;
+
+#endif
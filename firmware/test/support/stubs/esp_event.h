@@ -0,0 +1,8 @@
+#ifndef __ESP_EVENT_H
+#define __ESP_EVENT_H
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#endif
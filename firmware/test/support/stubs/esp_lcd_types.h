@@ -0,0 +1,4 @@
+#ifndef __ESP_LCD_TYPES_H
+#define __ESP_LCD_TYPES_H
+
+#endif
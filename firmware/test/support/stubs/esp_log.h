@@ -0,0 +1,29 @@
+#ifndef __ESP_LOG_H
+#define __ESP_LOG_H
+#include <stdarg.h>
+#include <stdio.h>
+
+// Host stand-in for ESP-IDF logging. Output is dropped unless ESP_LOG_STUB_PRINT is defined, so suites that feed
+// thousands of bad frames through a module stay readable.
+static inline void esp_log_stub(const char *level, const char *tag, const char *format, ...) {
+#ifdef ESP_LOG_STUB_PRINT
+  va_list args;
+  va_start(args, format);
+  printf("%s (%s): ", level, tag);
+  vprintf(format, args);
+  printf("\n");
+  va_end(args);
+#else
+  (void)level;
+  (void)tag;
+  (void)format;
+#endif
+}
+
+#define ESP_LOGE(tag, format, ...) esp_log_stub("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) esp_log_stub("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) esp_log_stub("I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) esp_log_stub("D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) esp_log_stub("V", tag, format, ##__VA_ARGS__)
+
+#endif
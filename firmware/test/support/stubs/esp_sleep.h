@@ -0,0 +1,5 @@
+#ifndef __ESP_SLEEP_H
+#define __ESP_SLEEP_H
+#include "esp_err.h"
+
+#endif
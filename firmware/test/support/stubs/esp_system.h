@@ -0,0 +1,5 @@
+#ifndef __ESP_SYSTEM_H
+#define __ESP_SYSTEM_H
+#include "esp_err.h"
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef __ESP_WIFI_H
+#define __ESP_WIFI_H
+#include "esp_err.h"
+#include "esp_event.h"
+#include <stdint.h>
+
+// Host stand-in for the WiFi channel API
+typedef enum {
+  WIFI_SECOND_CHAN_NONE = 0,
+} wifi_second_chan_t;
+
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second);
+esp_err_t esp_wifi_get_channel(uint8_t *primary, wifi_second_chan_t *second);
+
+#endif
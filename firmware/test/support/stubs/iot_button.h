@@ -0,0 +1,11 @@
+#ifndef __IOT_BUTTON_H
+#define __IOT_BUTTON_H
+#include "esp_err.h"
+
+// Host stand-in for the espressif/button component. Suites build without PRIMARY_BUTTON, so only the handle and
+// teardown are needed.
+typedef void *button_handle_t;
+
+esp_err_t iot_button_delete(button_handle_t btn_handle);
+
+#endif
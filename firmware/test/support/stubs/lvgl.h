@@ -0,0 +1,34 @@
+#ifndef __LVGL_H
+#define __LVGL_H
+#include <stdbool.h>
+#include <stdint.h>
+
+// Host stand-in for the LVGL declarations that module headers and the generated UI headers reference. Objects are
+// opaque, none of the suites draw anything.
+typedef struct _lv_obj_t lv_obj_t;
+typedef struct _lv_event_t lv_event_t;
+typedef struct _lv_anim_t lv_anim_t;
+typedef struct _lv_timer_t lv_timer_t;
+typedef struct _lv_indev_t lv_indev_t;
+typedef struct _lv_font_t lv_font_t;
+typedef struct {
+  const uint8_t *data;
+} lv_img_dsc_t;
+typedef int lv_scr_load_anim_t;
+typedef void (*lv_timer_cb_t)(lv_timer_t *timer);
+
+#define LV_IMG_DECLARE(name) extern const lv_img_dsc_t name
+#define LV_FONT_DECLARE(name) extern const lv_font_t name
+
+#ifndef LV_HOR_RES
+  #define LV_HOR_RES 240
+#endif
+#ifndef LV_VER_RES
+  #define LV_VER_RES 240
+#endif
+
+lv_timer_t *lv_timer_create(lv_timer_cb_t timer_cb, uint32_t period, void *user_data);
+void lv_label_set_text(lv_obj_t *obj, const char *text);
+void lv_disp_load_scr(lv_obj_t *scr);
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef __NVS_FLASH_H
+#define __NVS_FLASH_H
+#include "esp_err.h"
+#include <stddef.h>
+
+#endif
@@ -0,0 +1,5 @@
+#ifndef __ROM_GPIO_H
+#define __ROM_GPIO_H
+#include "driver/gpio.h"
+
+#endif
@@ -0,0 +1,124 @@
+#include "telemetry_encoder.h"
+#include <math.h>
+#include <string.h>
+
+static void put_u16(uint8_t *buf, size_t *ind, uint16_t value) {
+  buf[(*ind)++] = value >> 8;
+  buf[(*ind)++] = value;
+}
+
+static void put_u32(uint8_t *buf, size_t *ind, uint32_t value) {
+  put_u16(buf, ind, value >> 16);
+  put_u16(buf, ind, value);
+}
+
+// Quantize a field into its wire representation, widened to 32 bits
+static uint32_t quantize_field(TelemetryField field, const TelemetryData *data) {
+  switch (field) {
+  case TELEMETRY_FIELD_SPEED:
+    return (uint16_t)(int16_t)lroundf(data->speed * 10);
+  case TELEMETRY_FIELD_DUTY_CYCLE:
+    return (uint8_t)(int8_t)lroundf(data->duty_cycle * 100);
+  case TELEMETRY_FIELD_BATTERY_VOLTAGE:
+    return (uint16_t)(int16_t)lroundf(data->battery_voltage * 10);
+  case TELEMETRY_FIELD_BATTERY_LEVEL:
+    return (uint8_t)lroundf(data->battery_level * 2);
+  case TELEMETRY_FIELD_MOTOR_TEMP:
+    return (uint8_t)lroundf(data->motor_temp * 2);
+  case TELEMETRY_FIELD_CONTROLLER_TEMP:
+    return (uint8_t)lroundf(data->controller_temp * 2);
+  case TELEMETRY_FIELD_STATE:
+    return data->state;
+  case TELEMETRY_FIELD_SWITCH_STATE:
+    return data->switch_state;
+  case TELEMETRY_FIELD_TRIP_DISTANCE:
+    return (uint32_t)lroundf(data->trip_distance);
+  case TELEMETRY_FIELD_CURRENT:
+    return (uint16_t)(int16_t)lroundf(data->current * 10);
+  case TELEMETRY_FIELD_RPM:
+    return (uint16_t)data->rpm;
+  case TELEMETRY_FIELD_ODOMETER:
+    return data->odometer;
+  case TELEMETRY_FIELD_FAULT_CODE:
+    return data->fault_code;
+  case TELEMETRY_FIELD_PITCH:
+    return (uint16_t)(int16_t)lroundf(data->pitch * 10);
+  case TELEMETRY_FIELD_ROLL:
+    return (uint16_t)(int16_t)lroundf(data->roll * 10);
+  default:
+    return 0;
+  }
+}
+
+static uint8_t field_size(TelemetryField field) {
+  switch (field) {
+  case TELEMETRY_FIELD_SPEED:
+  case TELEMETRY_FIELD_BATTERY_VOLTAGE:
+  case TELEMETRY_FIELD_CURRENT:
+  case TELEMETRY_FIELD_RPM:
+  case TELEMETRY_FIELD_PITCH:
+  case TELEMETRY_FIELD_ROLL:
+    return 2;
+  case TELEMETRY_FIELD_TRIP_DISTANCE:
+  case TELEMETRY_FIELD_ODOMETER:
+    return 4;
+  default:
+    return 1;
+  }
+}
+
+uint16_t telemetry_encoder_diff(const TelemetryData *keyframe, const TelemetryData *data) {
+  uint16_t mask = 0;
+  for (int field = 0; field < TELEMETRY_FIELD_COUNT; field++) {
+    if (quantize_field(field, keyframe) != quantize_field(field, data)) {
+      mask |= 1 << field;
+    }
+  }
+  return mask;
+}
+
+size_t telemetry_encode(uint8_t *buf, size_t size, TelemetryFrameType frame_type, uint8_t sequence,
+                        uint8_t keyframe_id, uint16_t field_mask, const TelemetryData *data) {
+  if (frame_type == TELEMETRY_FRAME_KEY) {
+    field_mask = TELEMETRY_FIELD_MASK_ALL;
+  }
+
+  size_t len = TELEMETRY_HEADER_SIZE;
+  for (int field = 0; field < TELEMETRY_FIELD_COUNT; field++) {
+    if (field_mask & (1 << field)) {
+      len += field_size(field);
+    }
+  }
+
+  if (len > size) {
+    return 0;
+  }
+
+  size_t ind = 0;
+  buf[ind++] = TELEMETRY_VERSION;
+  buf[ind++] = frame_type;
+  buf[ind++] = sequence;
+  buf[ind++] = keyframe_id;
+  put_u16(buf, &ind, field_mask);
+
+  for (int field = 0; field < TELEMETRY_FIELD_COUNT; field++) {
+    if (!(field_mask & (1 << field))) {
+      continue;
+    }
+
+    uint32_t value = quantize_field(field, data);
+    switch (field_size(field)) {
+    case 4:
+      put_u32(buf, &ind, value);
+      break;
+    case 2:
+      put_u16(buf, &ind, value);
+      break;
+    default:
+      buf[ind++] = value;
+      break;
+    }
+  }
+
+  return ind;
+}
@@ -0,0 +1,19 @@
+#ifndef __TELEMETRY_ENCODER_H
+#define __TELEMETRY_ENCODER_H
+#include "remote/telemetry.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Host side encoder for the REM_SET_TELEMETRY payload (without command byte and secret code), standing in for the
+// sender in the receiver package. Values are quantized the same way the receiver does before sending.
+#define TELEMETRY_ENCODER_MAX_SIZE 64
+
+// Mask of the fields whose quantized value differs between the two frames
+uint16_t telemetry_encoder_diff(const TelemetryData *keyframe, const TelemetryData *data);
+
+// Write a frame carrying the fields in field_mask, keyframes always carry every field
+// @return The frame length, or 0 if it does not fit in size
+size_t telemetry_encode(uint8_t *buf, size_t size, TelemetryFrameType frame_type, uint8_t sequence,
+                        uint8_t keyframe_id, uint16_t field_mask, const TelemetryData *data);
+
+#endif
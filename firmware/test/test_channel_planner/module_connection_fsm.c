@@ -0,0 +1 @@
+#include "remote/connection_fsm.c"
@@ -0,0 +1 @@
+#include "remote/link_health.c"
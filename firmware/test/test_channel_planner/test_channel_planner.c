@@ -0,0 +1,283 @@
+#include "remote/channel_planner.c"
+#include "remote/connection_fsm.h"
+#include "remote/link_health.h"
+#include <stdlib.h>
+#include <unity.h>
+
+// Reconnect simulation comparing the channel planner with the fixed sweep it replaced. The receiver sits on a channel
+// and sends board data at a fixed interval, each frame can be lost. The search finds it once a frame arrives while it
+// dwells on that channel. Every reconnect starts on the channel of the previous connection, like the receiver task.
+
+#define SIM_RECONNECTS 20000
+#define SIM_FRAME_LOSS_PCT 20
+// Dwell of the fixed sweep, which hopped to channel % 14 + 1
+#define SWEEP_DWELL_MS 200
+// Channels a receiver commonly ends up on, e.g. following the WiFi network of the board
+static const uint8_t common_channels[] = {1, 6, 11};
+
+typedef struct {
+  uint32_t p50_ms;
+  uint32_t p90_ms;
+  uint32_t p99_ms;
+  uint32_t max_ms;
+} ReconnectTimes;
+
+typedef struct {
+  uint32_t (*start)(uint8_t last_good_channel);
+  uint8_t (*next)(uint8_t channel);
+  uint32_t (*dwell_ms)();
+} SearchPolicy;
+
+// Separate streams for where the receiver goes and for the radio, so every policy meets the same receiver moves
+static uint32_t receiver_rng;
+static uint32_t radio_rng;
+
+static uint32_t rng_next(uint32_t *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+static uint32_t sweep_start(uint8_t last_good_channel) {
+  return SWEEP_DWELL_MS;
+}
+
+static uint8_t sweep_next(uint8_t channel) {
+  return channel % CHANNEL_PLANNER_NUM_CHANNELS + 1;
+}
+
+static uint32_t sweep_dwell_ms() {
+  return SWEEP_DWELL_MS;
+}
+
+static uint32_t planner_start(uint8_t last_good_channel) {
+  channel_planner_start(last_good_channel, false);
+  return channel_planner_get_dwell_ms();
+}
+
+static uint8_t planner_next(uint8_t channel) {
+  return channel_planner_next();
+}
+
+static uint32_t planner_dwell_ms() {
+  return channel_planner_get_dwell_ms();
+}
+
+static const SearchPolicy sweep = {sweep_start, sweep_next, sweep_dwell_ms};
+static const SearchPolicy planner = {planner_start, planner_next, planner_dwell_ms};
+
+// Where the receiver is when the link drops: mostly where it was, sometimes on one of the channels it used before
+static uint8_t pick_receiver_channel(uint8_t current, uint8_t stay_pct, uint8_t common_pct) {
+  uint32_t roll = rng_next(&receiver_rng) % 100;
+  if (roll < stay_pct) {
+    return current;
+  }
+  else if (roll < stay_pct + common_pct) {
+    return common_channels[rng_next(&receiver_rng) % sizeof(common_channels)];
+  }
+
+  return rng_next(&receiver_rng) % 13 + 1;
+}
+
+// Time until a frame from the receiver is heard during one dwell, or 0 if none is
+static uint32_t hear_receiver(uint32_t dwell_ms, uint32_t frame_interval_ms) {
+  for (uint32_t arrival = rng_next(&radio_rng) % frame_interval_ms; arrival < dwell_ms; arrival += frame_interval_ms) {
+    if (rng_next(&radio_rng) % 100 >= SIM_FRAME_LOSS_PCT) {
+      return arrival + 1;
+    }
+  }
+
+  return 0;
+}
+
+static int compare_u32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static ReconnectTimes simulate(const SearchPolicy *policy, uint32_t frame_interval_ms, uint8_t stay_pct,
+                               uint8_t common_pct) {
+  static uint32_t times[SIM_RECONNECTS];
+  receiver_rng = 0x2545F491;
+  radio_rng = 0x9E3779B9;
+  memset(channel_history, 0, sizeof(channel_history));
+
+  uint8_t receiver_channel = 1;
+  uint8_t remote_channel = 1;
+
+  for (int i = 0; i < SIM_RECONNECTS; i++) {
+    receiver_channel = pick_receiver_channel(receiver_channel, stay_pct, common_pct);
+
+    uint32_t elapsed_ms = 0;
+    uint32_t dwell_ms = policy->start(remote_channel);
+    while (1) {
+      if (remote_channel == receiver_channel) {
+        uint32_t heard_ms = hear_receiver(dwell_ms, frame_interval_ms);
+        if (heard_ms > 0) {
+          elapsed_ms += heard_ms;
+          break;
+        }
+      }
+
+      elapsed_ms += dwell_ms;
+      remote_channel = policy->next(remote_channel);
+      dwell_ms = policy->dwell_ms();
+    }
+
+    channel_planner_record_success(remote_channel, -60 - (int)(rng_next(&radio_rng) % 20));
+    times[i] = elapsed_ms;
+  }
+
+  qsort(times, SIM_RECONNECTS, sizeof(times[0]), compare_u32);
+  ReconnectTimes result = {
+      .p50_ms = times[SIM_RECONNECTS / 2],
+      .p90_ms = times[SIM_RECONNECTS * 9 / 10],
+      .p99_ms = times[SIM_RECONNECTS * 99 / 100],
+      .max_ms = times[SIM_RECONNECTS - 1],
+  };
+  return result;
+}
+
+static void report(const char *name, const ReconnectTimes *times) {
+  char message[128];
+  snprintf(message, sizeof(message), "%s: p50 %u ms, p90 %u ms, p99 %u ms, max %u ms", name, times->p50_ms,
+           times->p90_ms, times->p99_ms, times->max_ms);
+  TEST_MESSAGE(message);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void test_planner_reconnects_faster_on_a_settled_receiver(void) {
+  // Short dropouts, the receiver mostly stays put and otherwise moves between a few channels
+  ReconnectTimes sweep_times = simulate(&sweep, 50, 70, 25);
+  ReconnectTimes planner_times = simulate(&planner, 50, 70, 25);
+  report("settled, sweep", &sweep_times);
+  report("settled, planner", &planner_times);
+
+  TEST_ASSERT_LESS_OR_EQUAL(sweep_times.p50_ms, planner_times.p50_ms);
+  TEST_ASSERT_LESS_THAN(sweep_times.p90_ms, planner_times.p90_ms);
+  TEST_ASSERT_LESS_THAN(sweep_times.p99_ms, planner_times.p99_ms);
+}
+
+static void test_planner_survives_a_wandering_receiver(void) {
+  // No history helps when the receiver lands on a random channel every time
+  ReconnectTimes sweep_times = simulate(&sweep, 50, 0, 0);
+  ReconnectTimes planner_times = simulate(&planner, 50, 0, 0);
+  report("wandering, sweep", &sweep_times);
+  report("wandering, planner", &planner_times);
+
+  // The longer first dwell and ranked order may cost a little, but never a whole extra pass
+  uint32_t pass_ms = CHANNEL_PLANNER_NUM_CHANNELS * SWEEP_DWELL_MS;
+  TEST_ASSERT_LESS_THAN(sweep_times.p90_ms + pass_ms / 4, planner_times.p90_ms);
+  TEST_ASSERT_LESS_THAN(sweep_times.max_ms + pass_ms, planner_times.max_ms);
+}
+
+static void test_slow_receiver_still_found_within_unknown_dwell(void) {
+  // Board data every 100 ms, close to the 120 ms dwell on channels without history
+  ReconnectTimes sweep_times = simulate(&sweep, 100, 50, 25);
+  ReconnectTimes planner_times = simulate(&planner, 100, 50, 25);
+  report("slow receiver, sweep", &sweep_times);
+  report("slow receiver, planner", &planner_times);
+
+  TEST_ASSERT_LESS_THAN(sweep_times.p90_ms, planner_times.p90_ms);
+}
+
+// Edge of range fade replayed through the link health model, the connection state machine and the planner the way the
+// connection and receiver tasks drive them. The receiver stays on its channel and is heard again after the gap.
+#define FADE_CHANNEL 6
+#define FADE_FRAME_INTERVAL_MS 50
+#define FADE_RSSI -88
+#define FADE_LEAD_IN_MS 3000
+
+typedef struct {
+  int64_t lost_after_ms; // Silence before reconnecting started, -1 if the gap was ridden out
+  int64_t recovery_ms;   // From the end of the gap to the first frame heard
+} FadeRecovery;
+
+static FadeRecovery replay_fade(int64_t gap_ms, bool is_reconnecting) {
+  memset(channel_history, 0, sizeof(channel_history));
+  link_health_reset();
+
+  FadeRecovery recovery = {.lost_after_ms = -1, .recovery_ms = -1};
+  ConnectionState state = CONNECTION_STATE_CONNECTED;
+  int64_t timer_deadline_ms = 0;
+  int64_t next_hop_ms = 0;
+  uint8_t channel = FADE_CHANNEL;
+  int64_t gap_start_ms = FADE_LEAD_IN_MS;
+  int64_t gap_end_ms = gap_start_ms + gap_ms;
+
+  for (int64_t t = 1; t < gap_end_ms + 10000; t++) {
+    bool is_sending = (t <= gap_start_ms || t >= gap_end_ms) && t % FADE_FRAME_INTERVAL_MS == 0;
+    ConnectionTransition transition;
+
+    if (is_sending && channel == FADE_CHANNEL) {
+      link_health_record_rx(FADE_RSSI, t * 1000);
+      transition = connection_fsm_transition(state, CONNECTION_EVENT_FRAME);
+      if (t >= gap_end_ms) {
+        recovery.recovery_ms = t - gap_end_ms;
+        return recovery;
+      }
+    }
+    else if (timer_deadline_ms > 0 && t >= timer_deadline_ms) {
+      ConnectionEvent event = CONNECTION_EVENT_TIMEOUT;
+      if (state == CONNECTION_STATE_CONNECTED) {
+        event = link_health_assess(t * 1000) == LINK_HEALTH_LOST ? CONNECTION_EVENT_LINK_LOST
+                                                                 : CONNECTION_EVENT_LINK_FADE;
+      }
+      transition = connection_fsm_transition(state, event);
+    }
+    else {
+      transition = (ConnectionTransition){.state = state, .timer_ms = 0};
+    }
+
+    if (transition.timer_ms > 0) {
+      timer_deadline_ms = t + transition.timer_ms;
+    }
+
+    if (transition.state == CONNECTION_STATE_RECONNECTING && state != CONNECTION_STATE_RECONNECTING) {
+      recovery.lost_after_ms = t - gap_start_ms;
+      channel_planner_start(channel, is_reconnecting);
+      next_hop_ms = t + channel_planner_get_dwell_ms();
+    }
+    state = transition.state;
+
+    if (state == CONNECTION_STATE_RECONNECTING && t >= next_hop_ms) {
+      channel = channel_planner_next();
+      next_hop_ms = t + channel_planner_get_dwell_ms();
+    }
+  }
+
+  return recovery;
+}
+
+static void test_reconnect_returns_to_last_good_channel(void) {
+  // Weak signal, so the loss is called early and the search is already running when the receiver comes back
+  for (int64_t gap_ms = 500; gap_ms <= 900; gap_ms += 100) {
+    FadeRecovery sweep_recovery = replay_fade(gap_ms, false);
+    FadeRecovery revisit_recovery = replay_fade(gap_ms, true);
+
+    char message[128];
+    snprintf(message, sizeof(message), "%lld ms gap, lost after %lld ms: full sweep %lld ms, revisiting %lld ms",
+             (long long)gap_ms, (long long)revisit_recovery.lost_after_ms, (long long)sweep_recovery.recovery_ms,
+             (long long)revisit_recovery.recovery_ms);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_TRUE(revisit_recovery.lost_after_ms > 0 && revisit_recovery.lost_after_ms < gap_ms);
+    // Back at most one probe and one frame later
+    TEST_ASSERT_TRUE(revisit_recovery.recovery_ms >= 0);
+    TEST_ASSERT_LESS_OR_EQUAL(KNOWN_DWELL_MS + FADE_FRAME_INTERVAL_MS, revisit_recovery.recovery_ms);
+  }
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_planner_reconnects_faster_on_a_settled_receiver);
+  RUN_TEST(test_planner_survives_a_wandering_receiver);
+  RUN_TEST(test_slow_receiver_still_found_within_unknown_dwell);
+  RUN_TEST(test_reconnect_returns_to_last_good_channel);
+  return UNITY_END();
+}
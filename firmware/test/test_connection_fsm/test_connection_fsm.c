@@ -0,0 +1,182 @@
+#include "remote/connection.c"
+#include "fakes.h"
+#include <unity.h>
+
+// Every state against every event through connection_fsm_transition, then the same transitions driven through
+// handle_event to check the caller applies the SAVE_PAIRING action and the link health verdict.
+
+#define STATE_COUNT (CONNECTION_STATE_RECONNECTING + 1)
+#define EVENT_COUNT (CONNECTION_EVENT_LINK_LOST + 1)
+
+static const ConnectionTransition expected[STATE_COUNT][EVENT_COUNT] = {
+    [CONNECTION_STATE_DISCONNECTED] =
+        {
+            [CONNECTION_EVENT_CONNECT] = {CONNECTION_STATE_CONNECTING, CONNECTION_ACTION_NONE,
+                                          CONNECTION_GIVE_UP_TIMEOUT_MS},
+            [CONNECTION_EVENT_DISCONNECT] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+            [CONNECTION_EVENT_FRAME] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+            [CONNECTION_EVENT_TIMEOUT] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+            [CONNECTION_EVENT_LINK_FADE] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+            [CONNECTION_EVENT_LINK_LOST] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+        },
+    [CONNECTION_STATE_CONNECTING] =
+        {
+            [CONNECTION_EVENT_CONNECT] = {CONNECTION_STATE_CONNECTING, CONNECTION_ACTION_NONE,
+                                          CONNECTION_GIVE_UP_TIMEOUT_MS},
+            [CONNECTION_EVENT_DISCONNECT] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+            [CONNECTION_EVENT_FRAME] = {CONNECTION_STATE_CONNECTED, CONNECTION_ACTION_SAVE_PAIRING,
+                                        CONNECTION_HEALTH_CHECK_MS},
+            [CONNECTION_EVENT_TIMEOUT] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+            [CONNECTION_EVENT_LINK_FADE] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+            [CONNECTION_EVENT_LINK_LOST] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+        },
+    [CONNECTION_STATE_CONNECTED] =
+        {
+            [CONNECTION_EVENT_CONNECT] = {CONNECTION_STATE_CONNECTING, CONNECTION_ACTION_NONE,
+                                          CONNECTION_GIVE_UP_TIMEOUT_MS},
+            [CONNECTION_EVENT_DISCONNECT] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+            [CONNECTION_EVENT_FRAME] = {CONNECTION_STATE_CONNECTED, CONNECTION_ACTION_NONE, CONNECTION_HEALTH_CHECK_MS},
+            [CONNECTION_EVENT_TIMEOUT] = {CONNECTION_STATE_RECONNECTING, CONNECTION_ACTION_NONE,
+                                          CONNECTION_GIVE_UP_TIMEOUT_MS},
+            [CONNECTION_EVENT_LINK_FADE] = {CONNECTION_STATE_CONNECTED, CONNECTION_ACTION_NONE,
+                                            CONNECTION_HEALTH_CHECK_MS},
+            [CONNECTION_EVENT_LINK_LOST] = {CONNECTION_STATE_RECONNECTING, CONNECTION_ACTION_NONE,
+                                            CONNECTION_GIVE_UP_TIMEOUT_MS},
+        },
+    [CONNECTION_STATE_RECONNECTING] =
+        {
+            [CONNECTION_EVENT_CONNECT] = {CONNECTION_STATE_CONNECTING, CONNECTION_ACTION_NONE,
+                                          CONNECTION_GIVE_UP_TIMEOUT_MS},
+            [CONNECTION_EVENT_DISCONNECT] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+            [CONNECTION_EVENT_FRAME] = {CONNECTION_STATE_CONNECTED, CONNECTION_ACTION_NONE, CONNECTION_HEALTH_CHECK_MS},
+            [CONNECTION_EVENT_TIMEOUT] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+            [CONNECTION_EVENT_LINK_FADE] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+            [CONNECTION_EVENT_LINK_LOST] = {CONNECTION_STATE_DISCONNECTED, CONNECTION_ACTION_NONE, 0},
+        },
+};
+
+static int save_pairing_count;
+static int save_peer_count;
+static uint8_t recorded_channel;
+static LinkHealth link_health;
+
+esp_err_t save_pairing_data() {
+  save_pairing_count++;
+  return ESP_OK;
+}
+
+void peers_save_active() {
+  save_peer_count++;
+}
+
+void channel_planner_record_success(uint8_t channel, int rssi) {
+  recorded_channel = channel;
+}
+
+LinkHealth link_health_assess(int64_t now_us) {
+  return link_health;
+}
+
+// Lets the armed timer run out, so the timeout isn't dropped as stale
+static void expire_timer() {
+  fake_time_us += (int64_t)CONNECTION_GIVE_UP_TIMEOUT_MS * 1000;
+  handle_event(CONNECTION_EVENT_TIMEOUT);
+}
+
+void setUp(void) {
+  save_pairing_count = 0;
+  save_peer_count = 0;
+  recorded_channel = 0;
+  link_health = LINK_HEALTH_GOOD;
+  fake_time_us = 100 * 1000000LL;
+  memset(&pairing_settings, 0, sizeof(pairing_settings));
+  pairing_settings.secret_code = DEFAULT_PAIRING_SECRET_CODE;
+  pairing_settings.channel = 6;
+  connection_state = CONNECTION_STATE_DISCONNECTED;
+  connection_init();
+}
+
+void tearDown(void) {
+  vQueueDelete(connection_mutex);
+  connection_mutex = NULL;
+}
+
+static void test_every_state_and_event(void) {
+  for (int state = 0; state < STATE_COUNT; state++) {
+    for (int event = 0; event < EVENT_COUNT; event++) {
+      ConnectionTransition transition = connection_fsm_transition(state, event);
+
+      char message[48];
+      snprintf(message, sizeof(message), "state %d, event %d", state, event);
+      TEST_ASSERT_EQUAL_INT_MESSAGE(expected[state][event].state, transition.state, message);
+      TEST_ASSERT_EQUAL_UINT8_MESSAGE(expected[state][event].actions, transition.actions, message);
+      TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected[state][event].timer_ms, transition.timer_ms, message);
+    }
+  }
+}
+
+static void test_first_frame_saves_pairing_once(void) {
+  uint8_t mac[ESP_NOW_ETH_ALEN] = {0x84, 0xFC, 0xE6, 0x50, 0xA8, 0x0C};
+  connection_connect_to_peer(mac, 6);
+  TEST_ASSERT_EQUAL_INT(CONNECTION_STATE_CONNECTING, connection_state);
+  TEST_ASSERT_EQUAL_INT(0, save_pairing_count);
+
+  handle_event(CONNECTION_EVENT_FRAME);
+  TEST_ASSERT_EQUAL_INT(CONNECTION_STATE_CONNECTED, connection_state);
+  TEST_ASSERT_EQUAL_INT(1, save_pairing_count);
+  TEST_ASSERT_EQUAL_INT(1, save_peer_count);
+  TEST_ASSERT_EQUAL_UINT8(6, recorded_channel);
+
+  // Later frames and a reconnect to the same receiver don't write flash again
+  handle_event(CONNECTION_EVENT_FRAME);
+  link_health = LINK_HEALTH_LOST;
+  expire_timer();
+  TEST_ASSERT_EQUAL_INT(CONNECTION_STATE_RECONNECTING, connection_state);
+  handle_event(CONNECTION_EVENT_FRAME);
+  TEST_ASSERT_EQUAL_INT(CONNECTION_STATE_CONNECTED, connection_state);
+  TEST_ASSERT_EQUAL_INT(1, save_pairing_count);
+  TEST_ASSERT_EQUAL_INT(1, save_peer_count);
+}
+
+static void test_silence_while_connected_follows_link_health(void) {
+  uint8_t mac[ESP_NOW_ETH_ALEN] = {0x84, 0xFC, 0xE6, 0x50, 0xA8, 0x0C};
+  connection_connect_to_peer(mac, 6);
+  handle_event(CONNECTION_EVENT_FRAME);
+
+  link_health = LINK_HEALTH_FADE;
+  expire_timer();
+  TEST_ASSERT_EQUAL_INT(CONNECTION_STATE_CONNECTED, connection_state);
+
+  link_health = LINK_HEALTH_LOST;
+  expire_timer();
+  TEST_ASSERT_EQUAL_INT(CONNECTION_STATE_RECONNECTING, connection_state);
+
+  // Reconnecting gives up when the timer runs out
+  expire_timer();
+  TEST_ASSERT_EQUAL_INT(CONNECTION_STATE_DISCONNECTED, connection_state);
+}
+
+static void test_stale_timeout_is_ignored(void) {
+  uint8_t mac[ESP_NOW_ETH_ALEN] = {0x84, 0xFC, 0xE6, 0x50, 0xA8, 0x0C};
+  connection_connect_to_peer(mac, 6);
+  handle_event(CONNECTION_EVENT_FRAME);
+
+  // A frame re-armed the timer after it fired, the queued timeout must not drop the link
+  link_health = LINK_HEALTH_LOST;
+  fake_time_us += (CONNECTION_HEALTH_CHECK_MS - 1) * 1000LL;
+  handle_event(CONNECTION_EVENT_TIMEOUT);
+  TEST_ASSERT_EQUAL_INT(CONNECTION_STATE_CONNECTED, connection_state);
+
+  connection_disconnect();
+  handle_event(CONNECTION_EVENT_TIMEOUT);
+  TEST_ASSERT_EQUAL_INT(CONNECTION_STATE_DISCONNECTED, connection_state);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_every_state_and_event);
+  RUN_TEST(test_first_frame_saves_pairing_once);
+  RUN_TEST(test_silence_while_connected_follows_link_health);
+  RUN_TEST(test_stale_timeout_is_ignored);
+  return UNITY_END();
+}
@@ -0,0 +1,108 @@
+#include "remote/session_key.c"
+#include "esp_timer.h"
+#include "mbedtls/ccm.h"
+#include "remote/remoteinputs.h"
+#include <unity.h>
+
+// Runs on the remote itself: pio test -e <board env>. The native env skips test_embedded_* suites.
+//
+// ESP-NOW seals and opens frames in the WiFi hardware with CCMP, which can't be timed from here on its own. The
+// benchmark runs the same construction in software (AES-128 CCM, 13 byte nonce, 8 byte MIC) over the largest input
+// frame with the derived key, so it's the CPU cost of the link if the hardware path were ever unavailable, and an
+// upper bound of what encryption adds per frame. Key derivation runs once per connection and is timed as well.
+
+#define BENCHMARK_ITERATIONS 1000
+#define CCMP_NONCE_SIZE 13
+#define CCMP_MIC_SIZE 8
+// Command byte, secret code and packed input state
+#define INPUT_FRAME_SIZE (1 + 4 + sizeof(PackedRemoteData))
+
+static const uint8_t receiver_mac[ESP_NOW_ETH_ALEN] = {0x84, 0xFC, 0xE6, 0x50, 0xA8, 0x0C};
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void test_key_depends_on_secret_code(void) {
+  uint8_t key[ESP_NOW_KEY_LEN];
+  uint8_t same_key[ESP_NOW_KEY_LEN];
+  uint8_t other_key[ESP_NOW_KEY_LEN];
+  TEST_ASSERT_EQUAL(ESP_OK, session_key_derive(0x12345678, receiver_mac, key));
+  TEST_ASSERT_EQUAL(ESP_OK, session_key_derive(0x12345678, receiver_mac, same_key));
+  TEST_ASSERT_EQUAL(ESP_OK, session_key_derive(0x12345679, receiver_mac, other_key));
+
+  TEST_ASSERT_EQUAL_MEMORY(key, same_key, ESP_NOW_KEY_LEN);
+  TEST_ASSERT_FALSE(memcmp(key, other_key, ESP_NOW_KEY_LEN) == 0);
+}
+
+static void test_benchmark_derive(void) {
+  uint8_t key[ESP_NOW_KEY_LEN];
+
+  int64_t start = esp_timer_get_time();
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    TEST_ASSERT_EQUAL(ESP_OK, session_key_derive(i, receiver_mac, key));
+  }
+  int64_t elapsed_us = esp_timer_get_time() - start;
+
+  char message[96];
+  snprintf(message, sizeof(message), "session_key_derive %.1f us/call", (double)elapsed_us / BENCHMARK_ITERATIONS);
+  TEST_MESSAGE(message);
+}
+
+static void test_benchmark_seal_open(void) {
+  uint8_t key[ESP_NOW_KEY_LEN];
+  TEST_ASSERT_EQUAL(ESP_OK, session_key_derive(0x12345678, receiver_mac, key));
+
+  mbedtls_ccm_context ccm;
+  mbedtls_ccm_init(&ccm);
+  TEST_ASSERT_EQUAL(0, mbedtls_ccm_setkey(&ccm, MBEDTLS_CIPHER_ID_AES, key, ESP_NOW_KEY_LEN * 8));
+
+  uint8_t nonce[CCMP_NONCE_SIZE] = {};
+  uint8_t frame[INPUT_FRAME_SIZE];
+  uint8_t sealed[INPUT_FRAME_SIZE];
+  uint8_t opened[INPUT_FRAME_SIZE];
+  uint8_t mic[CCMP_MIC_SIZE];
+  for (int i = 0; i < INPUT_FRAME_SIZE; i++) {
+    frame[i] = i;
+  }
+
+  int64_t seal_us = 0;
+  int64_t open_us = 0;
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    // CCMP nonces carry the packet number, a new one per frame
+    nonce[CCMP_NONCE_SIZE - 1] = i;
+    nonce[CCMP_NONCE_SIZE - 2] = i >> 8;
+    frame[0] = i;
+
+    int64_t start = esp_timer_get_time();
+    TEST_ASSERT_EQUAL(0, mbedtls_ccm_encrypt_and_tag(&ccm, sizeof(frame), nonce, sizeof(nonce), NULL, 0, frame,
+                                                     sealed, mic, sizeof(mic)));
+    int64_t sealed_time = esp_timer_get_time();
+    TEST_ASSERT_EQUAL(0, mbedtls_ccm_auth_decrypt(&ccm, sizeof(sealed), nonce, sizeof(nonce), NULL, 0, sealed, opened,
+                                                  mic, sizeof(mic)));
+    int64_t opened_time = esp_timer_get_time();
+
+    seal_us += sealed_time - start;
+    open_us += opened_time - sealed_time;
+    TEST_ASSERT_EQUAL_MEMORY(frame, opened, sizeof(frame));
+  }
+
+  // A flipped bit has to fail the MIC
+  sealed[1] ^= 0x01;
+  TEST_ASSERT_NOT_EQUAL(0, mbedtls_ccm_auth_decrypt(&ccm, sizeof(sealed), nonce, sizeof(nonce), NULL, 0, sealed,
+                                                    opened, mic, sizeof(mic)));
+  mbedtls_ccm_free(&ccm);
+
+  char message[96];
+  snprintf(message, sizeof(message), "%d byte frame: seal %.1f us, open %.1f us", (int)INPUT_FRAME_SIZE,
+           (double)seal_us / BENCHMARK_ITERATIONS, (double)open_us / BENCHMARK_ITERATIONS);
+  TEST_MESSAGE(message);
+}
+
+void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_key_depends_on_secret_code);
+  RUN_TEST(test_benchmark_derive);
+  RUN_TEST(test_benchmark_seal_open);
+  UNITY_END();
+}
@@ -0,0 +1,90 @@
+#include "utilities/format_utils.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+
+#define BENCHMARK_ITERATIONS 200000
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void assert_formats(const char *expected, float value, uint8_t decimals) {
+  char buf[FORMAT_NUMBER_BUFFER_SIZE];
+  size_t written = format_fixed(buf, sizeof(buf), value, decimals);
+  TEST_ASSERT_EQUAL_STRING(expected, buf);
+  TEST_ASSERT_EQUAL(strlen(expected), written);
+}
+
+static void test_matches_printf_in_range(void) {
+  assert_formats("12.3", 12.34f, 1);
+  assert_formats("-12.3", -12.34f, 1);
+  assert_formats("0.05", 0.05f, 2);
+  assert_formats("42", 41.6f, 0);
+  assert_formats("-0.5", -0.45f, 1);
+  assert_formats("0.000", 0.0f, 3);
+}
+
+static void test_clamps_values_outside_int32(void) {
+  // 1e12 scaled by 10 used to overflow into a negative value
+  assert_formats("214748364.7", 1e12f, 1);
+  assert_formats("-214748364.7", -1e12f, 1);
+  assert_formats("2147483647", 2147483648.0f, 0);
+  assert_formats("-2147483647", -2147483648.0f, 0);
+  assert_formats("2147483647", INFINITY, 0);
+  assert_formats("-2147483647", -INFINITY, 0);
+  assert_formats("0", NAN, 0);
+}
+
+static void test_truncates_to_buffer(void) {
+  char buf[4];
+  size_t written = format_fixed(buf, sizeof(buf), 1234.5f, 1);
+  TEST_ASSERT_EQUAL(3, written);
+  TEST_ASSERT_EQUAL_STRING("123", buf);
+}
+
+static double elapsed_ns(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+// Compares against the asprintf/free pattern the stats screen used before format_fixed
+static void test_benchmark_against_asprintf(void) {
+  struct timespec start, end;
+  volatile size_t sink = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    char *text = NULL;
+    if (asprintf(&text, "%.1f", i * 0.37f) > 0) {
+      sink += text[0];
+    }
+    free(text);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double asprintf_ns = elapsed_ns(start, end) / BENCHMARK_ITERATIONS;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    char buf[FORMAT_NUMBER_BUFFER_SIZE];
+    format_fixed(buf, sizeof(buf), i * 0.37f, 1);
+    sink += buf[0];
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double format_fixed_ns = elapsed_ns(start, end) / BENCHMARK_ITERATIONS;
+
+  char message[96];
+  snprintf(message, sizeof(message), "asprintf %.1f ns/call, format_fixed %.1f ns/call", asprintf_ns, format_fixed_ns);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(sink > 0);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_matches_printf_in_range);
+  RUN_TEST(test_clamps_values_outside_int32);
+  RUN_TEST(test_truncates_to_buffer);
+  RUN_TEST(test_benchmark_against_asprintf);
+  return UNITY_END();
+}
@@ -0,0 +1,127 @@
+#include "remote/frame_pool.c"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unity.h>
+
+#define FLOOD_ITERATIONS 200000
+// Slots each thread holds at once, together more than the pool so both threads regularly hit exhaustion
+#define FLOOD_SLOTS_PER_THREAD 10
+
+// One flag per slot, set by whichever thread currently owns it
+static atomic_bool slot_owned[FRAME_POOL_SIZE];
+static atomic_uint double_handouts;
+static atomic_uint corrupted_slots;
+
+void setUp(void) {
+  frame_pool_init();
+  for (int i = 0; i < FRAME_POOL_SIZE; i++) {
+    atomic_store(&slot_owned[i], false);
+  }
+  atomic_store(&double_handouts, 0);
+  atomic_store(&corrupted_slots, 0);
+}
+
+void tearDown(void) {}
+
+static void *flood_pool(void *arg) {
+  uint8_t tag = (uint8_t)(uintptr_t)arg;
+  uint8_t held[FLOOD_SLOTS_PER_THREAD];
+  int held_count = 0;
+
+  for (int i = 0; i < FLOOD_ITERATIONS; i++) {
+    // Mostly acquire while below the limit, otherwise release the oldest slot
+    if (held_count < FLOOD_SLOTS_PER_THREAD && (i % 3) != 2) {
+      uint8_t slot = frame_pool_acquire();
+      if (slot == FRAME_POOL_INVALID_SLOT) {
+        continue;
+      }
+
+      if (atomic_exchange(&slot_owned[slot], true)) {
+        atomic_fetch_add(&double_handouts, 1);
+      }
+
+      // Stamp the whole slot, the other thread would overwrite it if it had the slot too
+      memset(frame_pool_data(slot), tag, FRAME_POOL_SLOT_SIZE);
+      held[held_count++] = slot;
+    }
+    else if (held_count > 0) {
+      uint8_t slot = held[0];
+      memmove(held, held + 1, --held_count);
+
+      uint8_t *data = frame_pool_data(slot);
+      if (data[0] != tag || data[FRAME_POOL_SLOT_SIZE - 1] != tag) {
+        atomic_fetch_add(&corrupted_slots, 1);
+      }
+
+      atomic_store(&slot_owned[slot], false);
+      frame_pool_release(slot);
+    }
+  }
+
+  while (held_count > 0) {
+    uint8_t slot = held[--held_count];
+    atomic_store(&slot_owned[slot], false);
+    frame_pool_release(slot);
+  }
+
+  return NULL;
+}
+
+static void test_acquire_hands_out_every_slot_once() {
+  bool seen[FRAME_POOL_SIZE] = {false};
+
+  for (int i = 0; i < FRAME_POOL_SIZE; i++) {
+    uint8_t slot = frame_pool_acquire();
+    TEST_ASSERT_LESS_THAN(FRAME_POOL_SIZE, slot);
+    TEST_ASSERT_FALSE(seen[slot]);
+    seen[slot] = true;
+  }
+
+  TEST_ASSERT_EQUAL_UINT8(FRAME_POOL_INVALID_SLOT, frame_pool_acquire());
+  TEST_ASSERT_EQUAL_UINT8(FRAME_POOL_SIZE, frame_pool_in_use());
+
+  frame_pool_release(5);
+  TEST_ASSERT_EQUAL_UINT8(5, frame_pool_acquire());
+}
+
+static void test_invalid_and_double_release_leave_pool_intact() {
+  uint8_t slot = frame_pool_acquire();
+
+  frame_pool_release(FRAME_POOL_INVALID_SLOT);
+  frame_pool_release(FRAME_POOL_SIZE);
+  TEST_ASSERT_EQUAL_UINT8(1, frame_pool_in_use());
+
+  frame_pool_release(slot);
+  frame_pool_release(slot);
+  TEST_ASSERT_EQUAL_UINT8(0, frame_pool_in_use());
+  TEST_ASSERT_NULL(frame_pool_data(FRAME_POOL_INVALID_SLOT));
+}
+
+// WiFi task and receiver task stand-ins hammering the pool at the same time
+static void test_concurrent_flood_never_leaks_or_shares_a_slot() {
+  pthread_t producer;
+  pthread_t consumer;
+
+  TEST_ASSERT_EQUAL(0, pthread_create(&producer, NULL, flood_pool, (void *)(uintptr_t)0xA5));
+  TEST_ASSERT_EQUAL(0, pthread_create(&consumer, NULL, flood_pool, (void *)(uintptr_t)0x5A));
+  pthread_join(producer, NULL);
+  pthread_join(consumer, NULL);
+
+  TEST_ASSERT_EQUAL_UINT(0, atomic_load(&double_handouts));
+  TEST_ASSERT_EQUAL_UINT(0, atomic_load(&corrupted_slots));
+  TEST_ASSERT_EQUAL_UINT8(0, frame_pool_in_use());
+
+  // Every slot is still usable after the flood
+  for (int i = 0; i < FRAME_POOL_SIZE; i++) {
+    TEST_ASSERT_NOT_EQUAL(FRAME_POOL_INVALID_SLOT, frame_pool_acquire());
+  }
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_acquire_hands_out_every_slot_once);
+  RUN_TEST(test_invalid_and_double_release_leave_pool_intact);
+  RUN_TEST(test_concurrent_flood_never_leaks_or_shares_a_slot);
+  return UNITY_END();
+}
@@ -0,0 +1,156 @@
+#include "remote/group.c"
+#include "fakes.h"
+#include <unity.h>
+
+// The group sends on the active receiver's channel only. These cases pin which roster members get the input frame
+// depending on the channel they were last heard on or last connected on.
+
+#define ACTIVE_CHANNEL 6
+
+static SavedPeers roster;
+static uint8_t sent_macs[MAX_SAVED_PEERS][ESP_NOW_ETH_ALEN];
+static int sent_count;
+
+SavedPeers peers_get() {
+  return roster;
+}
+
+bool peers_find(const uint8_t *mac_addr, SavedPeer *peer) {
+  for (int i = 0; i < roster.deviceCount; i++) {
+    if (memcmp(roster.devices[i].mac, mac_addr, ESP_NOW_ETH_ALEN) == 0) {
+      *peer = roster.devices[i];
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Decoding is covered by the telemetry suite, only the slot bookkeeping matters here
+bool decode_board_data(const uint8_t *data, int len, TelemetryData *telemetry) {
+  memset(telemetry, 0, sizeof(TelemetryData));
+  return true;
+}
+
+TelemetryDecodeResult telemetry_decode_peer(TelemetryDecoder *decoder, const uint8_t *data, int len,
+                                            TelemetryData *telemetry) {
+  return TELEMETRY_DECODE_OK;
+}
+
+esp_err_t esp_now_send(const uint8_t *peer_addr, const uint8_t *data, size_t len) {
+  memcpy(sent_macs[sent_count++], peer_addr, ESP_NOW_ETH_ALEN);
+  return ESP_OK;
+}
+
+static void add_member(uint8_t id, uint8_t channel) {
+  SavedPeer *peer = &roster.devices[roster.deviceCount++];
+  memset(peer, 0, sizeof(SavedPeer));
+  peer->mac[5] = id;
+  peer->channel = channel;
+  peer->secret_code = 1000 + id;
+  snprintf(peer->name, sizeof(peer->name), "board %d", id);
+}
+
+// Core data frame from a member, heard on channel
+static void hear_member(uint8_t id, uint8_t channel) {
+  uint8_t mac[ESP_NOW_ETH_ALEN] = {0, 0, 0, 0, 0, id};
+  uint8_t frame[32] = {REM_SET_CORE_DATA};
+  uint32_t secret_code = 1000 + id;
+  // Secret code is big endian on air
+  frame[3] = secret_code >> 8;
+  frame[4] = secret_code & 0xFF;
+  TEST_ASSERT_TRUE(group_process_data(mac, -60, channel, frame, sizeof(frame)));
+}
+
+static bool was_sent_to(uint8_t id) {
+  for (int i = 0; i < sent_count; i++) {
+    if (sent_macs[i][5] == id) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void send_input_state() {
+  RemoteData data = {};
+  sent_count = 0;
+  group_send_input_state(&data);
+}
+
+void setUp(void) {
+  memset(&roster, 0, sizeof(roster));
+  memset(group_slots, 0, sizeof(group_slots));
+  memset(&pairing_settings, 0, sizeof(pairing_settings));
+  fake_time_us = 100 * 1000000LL;
+
+  // Board 1 is the active receiver
+  add_member(1, ACTIVE_CHANNEL);
+  pairing_settings.remote_addr[5] = 1;
+  pairing_settings.channel = ACTIVE_CHANNEL;
+}
+
+void tearDown(void) {}
+
+static void test_members_on_other_channels_are_skipped(void) {
+  add_member(2, ACTIVE_CHANNEL);
+  add_member(3, 11);
+  add_member(4, 0); // Never connected, channel unknown
+
+  send_input_state();
+
+  TEST_ASSERT_FALSE(was_sent_to(1));
+  TEST_ASSERT_TRUE(was_sent_to(2));
+  TEST_ASSERT_FALSE(was_sent_to(3));
+  TEST_ASSERT_TRUE(was_sent_to(4));
+  TEST_ASSERT_EQUAL_INT(2, sent_count);
+}
+
+static void test_heard_channel_overrides_saved_channel(void) {
+  add_member(2, 11);
+  add_member(3, ACTIVE_CHANNEL);
+
+  // Board 2 moved to our channel, board 3 moved away
+  hear_member(2, ACTIVE_CHANNEL);
+  hear_member(3, 1);
+  send_input_state();
+
+  TEST_ASSERT_TRUE(was_sent_to(2));
+  TEST_ASSERT_FALSE(was_sent_to(3));
+
+  GroupSlot slots[GROUP_MAX_SLOTS];
+  uint8_t count = group_get_slots(slots);
+  TEST_ASSERT_EQUAL_UINT8(2, count);
+  for (int i = 0; i < count; i++) {
+    TEST_ASSERT_EQUAL_UINT32(slots[i].mac[5] == 3 ? 1 : 0, slots[i].off_channel_skips);
+  }
+
+  // Once board 3 goes quiet its saved channel applies again
+  fake_time_us += GROUP_MEMBER_TIMEOUT_MS * 1000LL;
+  send_input_state();
+  TEST_ASSERT_TRUE(was_sent_to(3));
+}
+
+static void test_member_count_drops_quiet_boards(void) {
+  add_member(2, ACTIVE_CHANNEL);
+  add_member(3, ACTIVE_CHANNEL);
+
+  TEST_ASSERT_EQUAL_UINT8(0, group_get_member_count());
+
+  hear_member(2, ACTIVE_CHANNEL);
+  hear_member(3, ACTIVE_CHANNEL);
+  TEST_ASSERT_EQUAL_UINT8(2, group_get_member_count());
+
+  fake_time_us += (GROUP_MEMBER_TIMEOUT_MS / 2) * 1000LL;
+  hear_member(3, ACTIVE_CHANNEL);
+  fake_time_us += (GROUP_MEMBER_TIMEOUT_MS / 2) * 1000LL;
+  TEST_ASSERT_EQUAL_UINT8(1, group_get_member_count());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_members_on_other_channels_are_skipped);
+  RUN_TEST(test_heard_channel_overrides_saved_channel);
+  RUN_TEST(test_member_count_drops_quiet_boards);
+  return UNITY_END();
+}
@@ -0,0 +1,4 @@
+// Board pins normally come from the env, the suite builds the remote without a joystick or button
+#define I2C_SDA 0
+#define I2C_SCL 0
+#include "remote/remoteinputs.c"
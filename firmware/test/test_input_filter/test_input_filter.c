@@ -0,0 +1,261 @@
+#include "utilities/input_filter.c"
+#include "remote/adc.h"
+#include "remote/remoteinputs.h"
+#include <math.h>
+#include <stdio.h>
+#include <unity.h>
+
+// The thumbstick pipeline on synthetic ADC data: STICK_OVERSAMPLE_COUNT raw conversions per input cycle reduced with
+// median_u16, then iir_filter_update and the held axis conversion. The noise model is what the ESP32 ADC does to a
+// parked stick: a few codes of Gaussian-like noise on every conversion plus occasional conversions that spike to the
+// rails. It stands in for recorded ADC captures, which the suite does not have, so the margins below are only as good
+// as the model.
+
+#define CYCLES 20000
+#define NOISE_CODES 12     // Spread of the sum of uniforms, about +-12 codes
+#define SPIKE_PER_MILLE 30 // Conversions that come back at 0 or STICK_MAX_VAL
+
+static uint32_t rng_state;
+
+static uint32_t rng_next() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static uint16_t noisy_conversion(int true_value) {
+  if (rng_next() % 1000 < SPIKE_PER_MILLE) {
+    return rng_next() % 2 ? STICK_MAX_VAL : 0;
+  }
+
+  // Sum of four uniforms is close enough to Gaussian
+  int noise = 0;
+  for (int i = 0; i < 4; i++) {
+    noise += (int)(rng_next() % (NOISE_CODES / 2 + 1)) - NOISE_CODES / 4;
+  }
+
+  int value = true_value + noise;
+  return value < 0 ? 0 : value > STICK_MAX_VAL ? STICK_MAX_VAL : value;
+}
+
+typedef struct {
+  double rms;
+  int max_error;
+} FilterError;
+
+static void record_error(FilterError *error, double *sum_squares, int value, int true_value) {
+  int diff = abs(value - true_value);
+  *sum_squares += (double)diff * diff;
+  if (diff > error->max_error) {
+    error->max_error = diff;
+  }
+}
+
+void setUp(void) {
+  rng_state = 0xC0FFEE;
+}
+
+void tearDown(void) {}
+
+static void test_median_odd_even_and_limits(void) {
+  const uint16_t odd[] = {9, 1, 5, 7, 3};
+  TEST_ASSERT_EQUAL_UINT16(5, median_u16(odd, 5));
+
+  // Even counts average the middle pair, rounding half up
+  const uint16_t even[] = {10, 2, 4, 7};
+  TEST_ASSERT_EQUAL_UINT16(6, median_u16(even, 4));
+
+  const uint16_t one = 4095;
+  TEST_ASSERT_EQUAL_UINT16(4095, median_u16(&one, 1));
+  TEST_ASSERT_EQUAL_UINT16(0, median_u16(NULL, 0));
+
+  // Counts above the limit only look at the first MEDIAN_MAX_SAMPLES
+  uint16_t many[MEDIAN_MAX_SAMPLES + 4];
+  for (int i = 0; i < MEDIAN_MAX_SAMPLES; i++) {
+    many[i] = 100;
+  }
+  for (int i = MEDIAN_MAX_SAMPLES; i < MEDIAN_MAX_SAMPLES + 4; i++) {
+    many[i] = 4000;
+  }
+  TEST_ASSERT_EQUAL_UINT16(100, median_u16(many, MEDIAN_MAX_SAMPLES + 4));
+}
+
+static void test_median_rejects_rail_spikes(void) {
+  // Up to half the conversions minus one can hit the rails without moving the median off the true cluster
+  uint16_t samples[STICK_OVERSAMPLE_COUNT];
+  for (int spikes = 0; spikes < STICK_OVERSAMPLE_COUNT / 2; spikes++) {
+    for (int i = 0; i < STICK_OVERSAMPLE_COUNT; i++) {
+      samples[i] = i < spikes ? (i % 2 ? 0 : STICK_MAX_VAL) : 2040 + i;
+    }
+    uint16_t median = median_u16(samples, STICK_OVERSAMPLE_COUNT);
+    TEST_ASSERT_UINT16_WITHIN(STICK_OVERSAMPLE_COUNT, 2044, median);
+  }
+}
+
+static void test_iir_primes_and_converges(void) {
+  IirFilter filter;
+  iir_filter_init(&filter, 1);
+
+  // First sample is passed through rather than ramped up to from 0
+  TEST_ASSERT_EQUAL_UINT16(2047, iir_filter_update(&filter, 2047));
+
+  // A held value is reached exactly in both directions, no rounding bias is left behind
+  int cycles = 0;
+  while (iir_filter_update(&filter, 4095) != 4095) {
+    cycles++;
+    TEST_ASSERT_LESS_THAN_INT(20, cycles);
+  }
+  cycles = 0;
+  while (iir_filter_update(&filter, 0) != 0) {
+    cycles++;
+    TEST_ASSERT_LESS_THAN_INT(20, cycles);
+  }
+
+  // Shift 0 passes samples through
+  iir_filter_init(&filter, 0);
+  iir_filter_update(&filter, 100);
+  TEST_ASSERT_EQUAL_UINT16(3000, iir_filter_update(&filter, 3000));
+}
+
+static void test_parked_stick_stays_in_deadband(void) {
+  const int true_value = STICK_MID_VAL;
+  IirFilter filter;
+  iir_filter_init(&filter, STICK_FILTER_SHIFT);
+
+  FilterError raw = {};
+  FilterError median = {};
+  FilterError filtered = {};
+  double raw_squares = 0;
+  double median_squares = 0;
+  double filtered_squares = 0;
+
+  for (int cycle = 0; cycle < CYCLES; cycle++) {
+    uint16_t samples[STICK_OVERSAMPLE_COUNT];
+    for (int i = 0; i < STICK_OVERSAMPLE_COUNT; i++) {
+      samples[i] = noisy_conversion(true_value);
+    }
+
+    // What the task read before oversampling: one conversion per cycle
+    record_error(&raw, &raw_squares, samples[0], true_value);
+    uint16_t value = median_u16(samples, STICK_OVERSAMPLE_COUNT);
+    record_error(&median, &median_squares, value, true_value);
+    value = iir_filter_update(&filter, value);
+    record_error(&filtered, &filtered_squares, value, true_value);
+  }
+
+  raw.rms = sqrt(raw_squares / CYCLES);
+  median.rms = sqrt(median_squares / CYCLES);
+  filtered.rms = sqrt(filtered_squares / CYCLES);
+
+  char message[128];
+  snprintf(message, sizeof(message), "rms/max error in codes: raw %.1f/%d, median %.1f/%d, median+iir %.1f/%d",
+           raw.rms, raw.max_error, median.rms, median.max_error, filtered.rms, filtered.max_error);
+  TEST_MESSAGE(message);
+
+  // A single conversion regularly lands on a rail, the filtered value never leaves the deadband so the axis stays 0
+  TEST_ASSERT_EQUAL_INT(STICK_MAX_VAL - STICK_MID_VAL, raw.max_error);
+  TEST_ASSERT_LESS_THAN_INT(STICK_DEADBAND, filtered.max_error);
+  TEST_ASSERT_TRUE(filtered.rms <= median.rms);
+  TEST_ASSERT_TRUE(median.rms * 10 < raw.rms);
+}
+
+static void test_full_throw_settles_quickly(void) {
+  // Parked, then the stick is pushed to the end in one cycle. The filter may add one input cycle at most.
+  IirFilter filter;
+  iir_filter_init(&filter, STICK_FILTER_SHIFT);
+  uint16_t samples[STICK_OVERSAMPLE_COUNT];
+
+  for (int cycle = 0; cycle < 50; cycle++) {
+    for (int i = 0; i < STICK_OVERSAMPLE_COUNT; i++) {
+      samples[i] = noisy_conversion(STICK_MID_VAL);
+    }
+    iir_filter_update(&filter, median_u16(samples, STICK_OVERSAMPLE_COUNT));
+  }
+
+  const int target = 3900;
+  int settle_cycles = -1;
+  for (int cycle = 1; cycle <= 50; cycle++) {
+    for (int i = 0; i < STICK_OVERSAMPLE_COUNT; i++) {
+      samples[i] = noisy_conversion(target);
+    }
+    uint16_t value = iir_filter_update(&filter, median_u16(samples, STICK_OVERSAMPLE_COUNT));
+    if (settle_cycles < 0 && abs(value - target) < STICK_DEADBAND) {
+      settle_cycles = cycle;
+    }
+  }
+
+  char message[64];
+  snprintf(message, sizeof(message), "full throw within the deadband after %d cycles (%d ms)", settle_cycles,
+           settle_cycles * INPUT_RATE_MS);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(settle_cycles > 0);
+  TEST_ASSERT_LESS_OR_EQUAL_INT(2, settle_cycles);
+}
+
+// Packed axis changes per second with the stick held still at code true_value
+static double count_toggles_per_second(const AxisLut *lut, int true_value, bool is_held) {
+  IirFilter filter;
+  iir_filter_init(&filter, STICK_FILTER_SHIFT);
+  uint16_t samples[STICK_OVERSAMPLE_COUNT];
+  float axis = 0;
+  uint32_t toggles = 0;
+
+  for (int cycle = 0; cycle < CYCLES; cycle++) {
+    for (int i = 0; i < STICK_OVERSAMPLE_COUNT; i++) {
+      samples[i] = noisy_conversion(true_value);
+    }
+    uint16_t value = iir_filter_update(&filter, median_u16(samples, STICK_OVERSAMPLE_COUNT));
+    float new_axis = is_held ? axis_lut_convert_held(lut, value, axis) : axis_lut_convert(lut, value);
+
+    // The first cycle moves off the centre the axis starts at
+    if (new_axis != axis && cycle > 0) {
+      toggles++;
+    }
+    axis = new_axis;
+  }
+
+  return toggles / (CYCLES * INPUT_RATE_MS / 1000.0);
+}
+
+static void test_held_stick_does_not_toggle(void) {
+  // Default calibration, stick held off centre right on a 0.01 step boundary
+  static AxisLut lut;
+  AxisCalibration calibration = {
+      .min_val = STICK_MIN_VAL,
+      .mid_val = STICK_MID_VAL,
+      .max_val = STICK_MAX_VAL,
+      .deadband = STICK_DEADBAND,
+      .expo = STICK_EXPO,
+      .invert = false,
+  };
+  axis_lut_update(&lut, &calibration);
+
+  int boundary = STICK_MID_VAL + 1000;
+  while (lut.table[boundary] == lut.table[boundary - 1]) {
+    boundary++;
+  }
+
+  double plain_toggles = count_toggles_per_second(&lut, boundary, false);
+  double held_toggles = count_toggles_per_second(&lut, boundary, true);
+
+  char message[96];
+  snprintf(message, sizeof(message), "stick on the %d/%d step boundary: %.1f toggles/s, held %.2f toggles/s",
+           lut.table[boundary - 1], lut.table[boundary], plain_toggles, held_toggles);
+  TEST_MESSAGE(message);
+
+  // Every toggle is a frame the transmitter sends for nothing
+  TEST_ASSERT_TRUE(plain_toggles > 10);
+  TEST_ASSERT_TRUE(held_toggles < 0.1);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_median_odd_even_and_limits);
+  RUN_TEST(test_median_rejects_rail_spikes);
+  RUN_TEST(test_iir_primes_and_converges);
+  RUN_TEST(test_parked_stick_stays_in_deadband);
+  RUN_TEST(test_full_throw_settles_quickly);
+  RUN_TEST(test_held_stick_does_not_toggle);
+  return UNITY_END();
+}
@@ -0,0 +1,3 @@
+#include "fake_app.c"
+#include "fake_esp.c"
+#include "fake_freertos.c"
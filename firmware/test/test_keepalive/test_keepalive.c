@@ -0,0 +1,289 @@
+// Set by prebuild_hook.py in the device builds
+#define VERSION_MAJOR 0
+#define VERSION_MINOR 0
+#define VERSION_PATCH 0
+#include "remote/transmitter.c"
+#include "fakes.h"
+#include <setjmp.h>
+#include <unity.h>
+
+// Trace replay of the real transmitter task. The task runs on the test thread, its sleeps advance the fake clock to
+// the next input change of the trace or to the end of the wait, and every frame it sends is delivered or lost by the
+// trace, with the result fed back through the send callback. Loss is reported to the keepalive through the real
+// link_stats window, so backoff reacts to the trace the way it does on the device.
+
+// Estimated air time of one frame at the 1 Mbps ESP-NOW default rate: long preamble, vendor action frame overhead,
+// payload and FCS, plus the ACK
+#define AIRTIME_PREAMBLE_US 192
+#define AIRTIME_FRAME_OVERHEAD_BYTES 43
+#define AIRTIME_ACK_US 304
+// Start long after boot so the remote begins idle
+#define TRACE_START_US 100000000
+
+typedef struct {
+  int64_t duration_ms;
+  BoardState board_state;
+  // Time between stick changes, 0 while the stick is still
+  int64_t stick_change_ms;
+  uint8_t delivery_loss_pct;
+} TracePhase;
+
+typedef struct {
+  uint32_t frames;
+  uint64_t airtime_us;
+  uint32_t changes;
+  // From the oldest undelivered stick change to the first delivered frame after it
+  uint32_t delivered_changes;
+  uint64_t total_delivery_latency_us;
+  int64_t max_delivery_latency_us;
+  int64_t max_delivered_gap_us;
+  int64_t duration_us;
+} TraceResult;
+
+static const TracePhase *trace;
+static int trace_phases;
+static int64_t phase_end_us;
+static int phase;
+static int64_t next_change_us;
+static int8_t stick_step;
+static uint32_t loss_state;
+static bool ignore_loss_for_backoff;
+
+static esp_now_send_cb_t send_cb;
+static jmp_buf trace_end;
+static TraceResult result;
+static int64_t pending_change_us;
+static int64_t last_delivered_us;
+// First send of a stick change at or after this time is refused by the driver
+static int64_t send_error_us;
+static int64_t send_error_change_us;
+
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb) {
+  send_cb = cb;
+  return ESP_OK;
+}
+
+static bool is_lost(uint8_t loss_pct) {
+  // xorshift32, seeded per run so every policy variant sees the same losses
+  loss_state ^= loss_state << 13;
+  loss_state ^= loss_state >> 17;
+  loss_state ^= loss_state << 5;
+  return loss_state % 100 < loss_pct;
+}
+
+esp_err_t esp_now_send(const uint8_t *peer_addr, const uint8_t *data, size_t len) {
+  if (pending_change_us >= 0 && fake_time_us >= send_error_us) {
+    // Driver out of buffers, the frame never goes on air and no send callback follows
+    send_error_us = INT64_MAX;
+    send_error_change_us = pending_change_us;
+    return ESP_ERR_ESPNOW_NO_MEM;
+  }
+
+  result.frames++;
+  result.airtime_us += AIRTIME_PREAMBLE_US + (AIRTIME_FRAME_OVERHEAD_BYTES + len) * 8 + AIRTIME_ACK_US;
+
+  bool is_delivered = !is_lost(trace[phase].delivery_loss_pct);
+  if (is_delivered) {
+    if (pending_change_us >= 0) {
+      int64_t latency_us = fake_time_us - pending_change_us;
+      result.delivered_changes++;
+      result.total_delivery_latency_us += latency_us;
+      if (latency_us > result.max_delivery_latency_us) {
+        result.max_delivery_latency_us = latency_us;
+      }
+      pending_change_us = -1;
+    }
+
+    if (fake_time_us - last_delivered_us > result.max_delivered_gap_us) {
+      result.max_delivered_gap_us = fake_time_us - last_delivered_us;
+    }
+    last_delivered_us = fake_time_us;
+  }
+
+  send_cb(peer_addr, is_delivered || ignore_loss_for_backoff ? ESP_NOW_SEND_SUCCESS : ESP_NOW_SEND_FAIL);
+  return ESP_OK;
+}
+
+static void start_phase(int next_phase) {
+  phase = next_phase;
+  phase_end_us += trace[phase].duration_ms * 1000;
+  fake_stats.state = trace[phase].board_state;
+  next_change_us = trace[phase].stick_change_ms > 0 ? fake_time_us + trace[phase].stick_change_ms * 1000 : INT64_MAX;
+}
+
+// Stands in for the input task: moves the stick and notifies the transmitter
+static void change_stick() {
+  stick_step = (stick_step + 7) % 50;
+  remote_data.js_y = stick_step / 100.0f;
+  result.changes++;
+  if (pending_change_us < 0) {
+    pending_change_us = fake_time_us;
+  }
+  transmitter_notify_input_changed();
+  next_change_us = fake_time_us + trace[phase].stick_change_ms * 1000;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+  int64_t wake_us = fake_time_us + (int64_t)ticks * 1000;
+
+  while (1) {
+    int64_t event_us = next_change_us < phase_end_us ? next_change_us : phase_end_us;
+    if (event_us > wake_us) {
+      fake_time_us = wake_us;
+      return 0;
+    }
+
+    fake_time_us = event_us;
+    if (event_us == next_change_us) {
+      change_stick();
+      return 1;
+    }
+
+    if (phase + 1 == trace_phases) {
+      longjmp(trace_end, 1);
+    }
+    start_phase(phase + 1);
+  }
+}
+
+static TraceResult replay(const TracePhase *phases, int count, bool use_backoff) {
+  trace = phases;
+  trace_phases = count;
+  ignore_loss_for_backoff = !use_backoff;
+  memset(&result, 0, sizeof(result));
+  memset(&fake_stats, 0, sizeof(fake_stats));
+  memset(&remote_data, 0, sizeof(remote_data));
+  memset(&latency_stats, 0, sizeof(latency_stats));
+  receiver_capabilities = RECEIVER_CAPABILITY_PACKED_INPUT;
+  fake_time_us = TRACE_START_US;
+  phase_end_us = fake_time_us;
+  stick_step = 0;
+  loss_state = 0x9E3779B9;
+  pending_change_us = -1;
+  last_delivered_us = fake_time_us;
+  send_error_change_us = -1;
+  last_send_time = 0;
+  last_input_change_time = 0;
+  atomic_store(&input_changed_time_us, 0);
+  atomic_store(&last_delivery_time_ms, (uint32_t)(fake_time_us / 1000));
+  atomic_store(&retry_pending, false);
+  start_phase(0);
+
+  int64_t start_us = fake_time_us;
+  if (setjmp(trace_end) == 0) {
+    transmitter_task(NULL);
+  }
+
+  result.duration_us = fake_time_us - start_us;
+  vQueueDelete(send_result_queue);
+  send_result_queue = NULL;
+  return result;
+}
+
+static void report(const char *name, const TraceResult *trace_result) {
+  double seconds = trace_result->duration_us / 1e6;
+  char message[200];
+  snprintf(message, sizeof(message),
+           "%s: %.1f frames/s, airtime %.2f%%, delivery latency avg %.1f ms max %.1f ms, longest silence %.1f ms", name,
+           trace_result->frames / seconds, trace_result->airtime_us / (seconds * 1e4),
+           trace_result->delivered_changes
+               ? trace_result->total_delivery_latency_us / 1000.0 / trace_result->delivered_changes
+               : 0,
+           trace_result->max_delivery_latency_us / 1000.0, trace_result->max_delivered_gap_us / 1000.0);
+  TEST_MESSAGE(message);
+}
+
+void setUp(void) {
+  connection_state = CONNECTION_STATE_CONNECTED;
+  fake_stats_screen_active = true;
+  pairing_settings.secret_code = 0x12345678;
+  device_settings.tx_burst_count = DEFAULT_TX_BURST_COUNT;
+  send_error_us = INT64_MAX;
+}
+
+void tearDown(void) {}
+
+static void test_parked_remote_sends_idle_keepalive(void) {
+  const TracePhase parked[] = {{60000, BOARD_STATE_STOP_SWITCH_FULL, 0, 0}};
+  TraceResult parked_result = replay(parked, 1, true);
+  report("parked", &parked_result);
+
+  // Nothing but the slow keepalive
+  TEST_ASSERT_UINT32_WITHIN(2, 60000 / MAX_UPDATE_DELAY_MS, parked_result.frames);
+  TEST_ASSERT_EQUAL_INT64(MAX_UPDATE_DELAY_MS * 1000, parked_result.max_delivered_gap_us);
+}
+
+static void test_riding_keeps_fast_keepalive(void) {
+  // Steady riding with the stick still, then carving
+  const TracePhase riding[] = {
+      {30000, BOARD_STATE_RUNNING, 0, 0},
+      {30000, BOARD_STATE_RUNNING, 150, 0},
+  };
+  TraceResult riding_result = replay(riding, 2, true);
+  report("riding", &riding_result);
+
+  // Changes go out as they happen, silence never exceeds the active keepalive
+  TEST_ASSERT_EQUAL_INT64(0, riding_result.max_delivery_latency_us);
+  TEST_ASSERT_EQUAL_INT64(ACTIVE_UPDATE_DELAY_MS * 1000, riding_result.max_delivered_gap_us);
+  TEST_ASSERT_EQUAL_UINT32(0, latency_stats.max_latency_us);
+}
+
+static void test_stick_activity_holds_fast_keepalive(void) {
+  // Board not running, the stick moves briefly and then goes still
+  const TracePhase nudge[] = {
+      {1000, BOARD_STATE_STOP_SWITCH_FULL, 200, 0},
+      {10000, BOARD_STATE_STOP_SWITCH_FULL, 0, 0},
+  };
+  TraceResult nudge_result = replay(nudge, 2, true);
+  report("stick nudge", &nudge_result);
+
+  // 5 changes, about 20 active keepalives during the hold and then the idle rate
+  TEST_ASSERT_EQUAL_UINT32(5, nudge_result.changes);
+  TEST_ASSERT_UINT32_WITHIN(4, 5 + ACTIVE_INPUT_HOLD_MS / ACTIVE_UPDATE_DELAY_MS + 8000 / MAX_UPDATE_DELAY_MS,
+                            nudge_result.frames);
+}
+
+static void test_backoff_saves_airtime_on_lossy_link(void) {
+  // Riding through a stretch where most frames are lost
+  const TracePhase fade[] = {
+      {10000, BOARD_STATE_RUNNING, 150, 0},
+      {20000, BOARD_STATE_RUNNING, 150, 60},
+      {10000, BOARD_STATE_RUNNING, 150, 0},
+  };
+  TraceResult adaptive = replay(fade, 3, true);
+  report("fade with backoff", &adaptive);
+  TraceResult fixed = replay(fade, 3, false);
+  report("fade without backoff", &fixed);
+
+  TEST_ASSERT_TRUE(adaptive.airtime_us < fixed.airtime_us);
+  // Stick changes are still sent immediately, backoff only slows the repeats of unchanged input, so on average a
+  // change reaches the receiver about as fast
+  uint64_t adaptive_avg_us = adaptive.total_delivery_latency_us / adaptive.delivered_changes;
+  uint64_t fixed_avg_us = fixed.total_delivery_latency_us / fixed.delivered_changes;
+  TEST_ASSERT_TRUE(adaptive_avg_us <= fixed_avg_us * 3 / 2);
+  // A running board stops after 1 s without input, backoff must not stretch the silence that far
+  TEST_ASSERT_LESS_THAN_INT64(1000000, adaptive.max_delivered_gap_us);
+  TEST_ASSERT_LESS_THAN_INT64(1000000, adaptive.max_delivery_latency_us);
+}
+
+static void test_send_error_retries_change_promptly(void) {
+  // Riding with the stick moving slower than the active keepalive, one changed frame is refused by the driver
+  const TracePhase riding[] = {{10000, BOARD_STATE_RUNNING, 250, 0}};
+  send_error_us = TRACE_START_US + 5000 * 1000;
+  TraceResult error_result = replay(riding, 1, true);
+  report("send error", &error_result);
+
+  TEST_ASSERT_TRUE(send_error_change_us >= 0);
+  // Neither a notify nor the keepalive is due, the refused change goes out on the retry pace
+  TEST_ASSERT_EQUAL_INT64(TX_RATE_MS * 1000, error_result.max_delivery_latency_us);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_parked_remote_sends_idle_keepalive);
+  RUN_TEST(test_riding_keeps_fast_keepalive);
+  RUN_TEST(test_stick_activity_holds_fast_keepalive);
+  RUN_TEST(test_backoff_saves_airtime_on_lossy_link);
+  RUN_TEST(test_send_error_retries_change_promptly);
+  return UNITY_END();
+}
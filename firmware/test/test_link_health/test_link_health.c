@@ -0,0 +1,178 @@
+#include "remote/link_health.c"
+#include "remote/connection_fsm.h"
+#include <stdio.h>
+#include <unity.h>
+
+// Replays fade and loss traces through the link health model the way the connection task drives it: every frame from
+// the receiver re-arms a CONNECTION_HEALTH_CHECK_MS check, a FADE verdict re-arms it and the first LOST verdict starts
+// reconnecting. Each trace ends in a gap, and the suite checks which gaps are ridden out and how soon a loss is called.
+
+#define FRAME_INTERVAL_MS 50
+#define RSSI_NOISE_DB 2
+
+typedef struct {
+  const char *name;
+  int64_t duration_ms; // Time before the gap
+  int rssi_start;
+  int rssi_end;
+  uint8_t frame_loss_pct;
+  int64_t gap_ms;     // Silence after the last frame, -1 if the receiver never comes back
+  bool is_tx_failing; // Our own frames go undelivered during the gap
+} LinkTrace;
+
+typedef struct {
+  int64_t lost_after_ms; // Silence before the first LOST verdict, -1 if the gap was ridden out
+  uint32_t checks;
+} ReplayResult;
+
+static uint32_t rng_state;
+
+static uint32_t rng_next() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static ReplayResult replay(const LinkTrace *trace) {
+  link_health_reset();
+  rng_state = 0x1234567;
+
+  int64_t last_rx_ms = 0;
+  for (int64_t t = FRAME_INTERVAL_MS; t <= trace->duration_ms; t += FRAME_INTERVAL_MS) {
+    if (rng_next() % 100 < trace->frame_loss_pct) {
+      continue;
+    }
+
+    int rssi = trace->rssi_start + (trace->rssi_end - trace->rssi_start) * t / trace->duration_ms;
+    rssi += (int)(rng_next() % (2 * RSSI_NOISE_DB + 1)) - RSSI_NOISE_DB;
+    link_health_record_rx(rssi, t * 1000);
+    link_health_record_tx(true);
+    last_rx_ms = t;
+  }
+
+  // The health check timer from the last frame on. The gap ends with a frame that would cancel it.
+  ReplayResult result = {.lost_after_ms = -1};
+  for (int64_t check_ms = last_rx_ms + CONNECTION_HEALTH_CHECK_MS;
+       trace->gap_ms < 0 || check_ms < last_rx_ms + trace->gap_ms; check_ms += CONNECTION_HEALTH_CHECK_MS) {
+    if (trace->is_tx_failing) {
+      // Keepalives go out at least every 100 ms while the board is silent
+      link_health_record_tx(false);
+      link_health_record_tx(false);
+    }
+
+    result.checks++;
+    if (link_health_assess(check_ms * 1000) == LINK_HEALTH_LOST) {
+      result.lost_after_ms = check_ms - last_rx_ms;
+      break;
+    }
+  }
+
+  return result;
+}
+
+static void report(const LinkTrace *trace, ReplayResult result) {
+  char message[96];
+  if (result.lost_after_ms < 0) {
+    snprintf(message, sizeof(message), "%s: rode out the gap, %lu checks", trace->name, (unsigned long)result.checks);
+  }
+  else {
+    snprintf(message, sizeof(message), "%s: lost after %lld ms of silence, %lu checks", trace->name,
+             (long long)result.lost_after_ms, (unsigned long)result.checks);
+  }
+  TEST_MESSAGE(message);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void test_fades_are_ridden_out(void) {
+  const LinkTrace traces[] = {
+      {"strong signal, 600 ms gap", 5000, -60, -60, 0, 600, false},
+      {"strong signal, 950 ms gap", 5000, -55, -55, 0, 950, false},
+      {"30% frame loss, 400 ms gap", 5000, -70, -70, 30, 400, false},
+      {"edge of range, 180 ms gap", 5000, -84, -84, 0, 180, false},
+  };
+
+  for (int i = 0; i < sizeof(traces) / sizeof(traces[0]); i++) {
+    ReplayResult result = replay(&traces[i]);
+    report(&traces[i], result);
+    TEST_ASSERT_EQUAL_INT64_MESSAGE(-1, result.lost_after_ms, traces[i].name);
+  }
+}
+
+static void test_losses_are_called_early(void) {
+  // A loss is called at the first check after 4 intervals of silence (200 ms at 50 ms frames, the second 150 ms check)
+  // when the link looked bad, and at the first check past 1 s however healthy it looked
+  const LinkTrace traces[] = {
+      {"walking away", 3000, -60, -92, 0, -1, false},
+      {"weak signal", 3000, -90, -90, 0, -1, false},
+      {"strong signal, tx failing", 3000, -60, -60, 0, -1, true},
+      {"strong signal, board off", 3000, -55, -55, 0, -1, false},
+  };
+  const int64_t expected_lost_after_ms[] = {300, 300, 300, 1050};
+
+  for (int i = 0; i < sizeof(traces) / sizeof(traces[0]); i++) {
+    ReplayResult result = replay(&traces[i]);
+    report(&traces[i], result);
+    TEST_ASSERT_EQUAL_INT64_MESSAGE(expected_lost_after_ms[i], result.lost_after_ms, traces[i].name);
+  }
+}
+
+// Steady frames every interval_ms at rssi, then the silence to assess
+static LinkHealth assess_after(int64_t interval_ms, int rssi, int64_t silence_ms) {
+  link_health_reset();
+  int64_t t = 0;
+  for (int i = 0; i < 100; i++) {
+    t += interval_ms;
+    link_health_record_rx(rssi, t * 1000);
+  }
+
+  return link_health_assess((t + silence_ms) * 1000);
+}
+
+static void test_weak_rssi_threshold(void) {
+  // 250 ms of silence is past 4 intervals, only the signal decides
+  TEST_ASSERT_EQUAL_INT(LINK_HEALTH_FADE, assess_after(FRAME_INTERVAL_MS, -85, 250));
+  TEST_ASSERT_EQUAL_INT(LINK_HEALTH_LOST, assess_after(FRAME_INTERVAL_MS, -86, 250));
+}
+
+static void test_lost_after_four_intervals(void) {
+  // 100 ms frames put 4 intervals above the 200 ms floor. Read back the averaged interval rather than assume it.
+  assess_after(100, -90, 0);
+  int64_t four_intervals_ms = (int64_t)health.interval_us * LOST_INTERVALS / 1000;
+  TEST_ASSERT_INT64_WITHIN(1, 400, four_intervals_ms);
+
+  TEST_ASSERT_EQUAL_INT(LINK_HEALTH_GOOD, assess_after(100, -90, 2 * 100 - 1));
+  TEST_ASSERT_EQUAL_INT(LINK_HEALTH_FADE, assess_after(100, -90, four_intervals_ms - 1));
+  TEST_ASSERT_EQUAL_INT(LINK_HEALTH_LOST, assess_after(100, -90, four_intervals_ms + 1));
+
+  // Fast frames are floored at 200 ms
+  TEST_ASSERT_EQUAL_INT(LINK_HEALTH_FADE, assess_after(20, -90, 199));
+  TEST_ASSERT_EQUAL_INT(LINK_HEALTH_LOST, assess_after(20, -90, 200));
+}
+
+static void test_falling_rssi_threshold(void) {
+  // From a settled -50 dBm one frame d dB lower moves the fast average d/2 and the slow one d/16 dBm, so the trend is
+  // -7d/16 dBm. It reaches -6 dB at d = 14 while the signal itself stays far from weak.
+  for (int drop = 12; drop <= 16; drop++) {
+    assess_after(FRAME_INTERVAL_MS, -50, 0);
+    link_health_record_rx(-50 - drop, health.last_rx_us + FRAME_INTERVAL_MS * 1000);
+
+    bool is_falling = health.rssi_fast - health.rssi_slow <= FALLING_RSSI_TREND * 16;
+    TEST_ASSERT_EQUAL(drop >= 14, is_falling);
+    TEST_ASSERT_EQUAL_INT(drop >= 14 ? LINK_HEALTH_LOST : LINK_HEALTH_FADE,
+                         link_health_assess(health.last_rx_us + 250 * 1000));
+  }
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fades_are_ridden_out);
+  RUN_TEST(test_losses_are_called_early);
+  RUN_TEST(test_weak_rssi_threshold);
+  RUN_TEST(test_lost_after_four_intervals);
+  RUN_TEST(test_falling_rssi_threshold);
+  return UNITY_END();
+}
@@ -0,0 +1 @@
+#include "utilities/buffer_utils.c"
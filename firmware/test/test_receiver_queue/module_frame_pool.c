@@ -0,0 +1 @@
+#include "remote/frame_pool.c"
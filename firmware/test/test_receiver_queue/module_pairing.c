@@ -0,0 +1 @@
+#include "remote/pairing.c"
@@ -0,0 +1 @@
+#include "remote/telemetry.c"
@@ -0,0 +1,142 @@
+#include "remote/receiver.c"
+#include <unity.h>
+
+#define FRAME_LEN 8
+
+static uint8_t board_mac[ESP_NOW_ETH_ALEN] = {0x84, 0xFC, 0xE6, 0x50, 0xA8, 0x0C};
+
+void setUp(void) {
+  frame_pool_init();
+  if (espnow_queue != NULL) {
+    vQueueDelete(espnow_queue);
+  }
+  espnow_queue = xQueueCreate(RX_QUEUE_SIZE, sizeof(esp_now_event_t));
+  memset(&drop_stats, 0, sizeof(drop_stats));
+}
+
+void tearDown(void) {}
+
+// Hands a frame to the receive callback the way the WiFi task does, marker ends up in the second byte
+static void deliver(uint8_t command, uint8_t marker) {
+  uint8_t frame[FRAME_LEN] = {command, marker};
+  wifi_pkt_rx_ctrl_t rx_ctrl = {.rssi = -60, .channel = 1};
+  esp_now_recv_info_t recv_info = {.src_addr = board_mac, .rx_ctrl = &rx_ctrl};
+
+  on_data_recv(&recv_info, frame, sizeof(frame));
+}
+
+// Takes every queued frame like the receiver task does, returning their markers in order
+static int drain(uint8_t *markers) {
+  esp_now_event_t evt;
+  int count = 0;
+
+  while (xQueueReceive(espnow_queue, &evt, 0) == pdTRUE) {
+    uint8_t *data = frame_pool_data(evt.slot);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_EQUAL(FRAME_LEN, evt.len);
+    markers[count++] = data[1];
+    release_event(&evt);
+  }
+
+  return count;
+}
+
+static void test_burst_keeps_newest_frames_in_order() {
+  const int burst = RX_QUEUE_SIZE + 5;
+  for (int i = 0; i < burst; i++) {
+    deliver(REM_SET_TELEMETRY, i);
+  }
+
+  TEST_ASSERT_EQUAL_UINT8(RX_QUEUE_SIZE, frame_pool_in_use());
+
+  uint8_t markers[RX_QUEUE_SIZE];
+  TEST_ASSERT_EQUAL(RX_QUEUE_SIZE, drain(markers));
+  for (int i = 0; i < RX_QUEUE_SIZE; i++) {
+    TEST_ASSERT_EQUAL_UINT8(burst - RX_QUEUE_SIZE + i, markers[i]);
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(5, drop_stats.total);
+  TEST_ASSERT_EQUAL_UINT32(5, drop_stats.core_data);
+}
+
+static void test_evicted_slots_return_to_the_pool() {
+  // Many times the pool size, a leaked slot per eviction would exhaust it quickly
+  for (int i = 0; i < FRAME_POOL_SIZE * 20; i++) {
+    deliver(REM_SET_CORE_DATA, i);
+  }
+
+  TEST_ASSERT_EQUAL_UINT8(RX_QUEUE_SIZE, frame_pool_in_use());
+  TEST_ASSERT_EQUAL_UINT32(FRAME_POOL_SIZE * 20 - RX_QUEUE_SIZE, drop_stats.total);
+
+  uint8_t markers[RX_QUEUE_SIZE];
+  drain(markers);
+  TEST_ASSERT_EQUAL_UINT8(0, frame_pool_in_use());
+}
+
+static void test_drops_are_counted_by_evicted_command() {
+  // Queue full of old frames of every kind, then a burst that pushes all of them out
+  const uint8_t old_commands[RX_QUEUE_SIZE] = {
+      REM_SET_TELEMETRY, REM_PAIR_INIT,        REM_PAIR_BOND, REM_VERSION,       REM_RECEIVER_VERSION,
+      REM_SET_CORE_DATA, REM_PAIR_COMPLETE,    REM_VERSION,   REM_SET_TELEMETRY, REM_RECEIVER_CAPABILITIES,
+  };
+  for (int i = 0; i < RX_QUEUE_SIZE; i++) {
+    deliver(old_commands[i], i);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, drop_stats.total);
+
+  for (int i = 0; i < RX_QUEUE_SIZE; i++) {
+    deliver(REM_SET_TELEMETRY, 100 + i);
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(RX_QUEUE_SIZE, drop_stats.total);
+  TEST_ASSERT_EQUAL_UINT32(3, drop_stats.core_data);
+  TEST_ASSERT_EQUAL_UINT32(3, drop_stats.pairing);
+  TEST_ASSERT_EQUAL_UINT32(3, drop_stats.version);
+  TEST_ASSERT_EQUAL_UINT32(1, drop_stats.other);
+
+  uint8_t markers[RX_QUEUE_SIZE];
+  TEST_ASSERT_EQUAL(RX_QUEUE_SIZE, drain(markers));
+  TEST_ASSERT_EQUAL_UINT8(100, markers[0]);
+  TEST_ASSERT_EQUAL_UINT8(100 + RX_QUEUE_SIZE - 1, markers[RX_QUEUE_SIZE - 1]);
+}
+
+static void test_exhausted_pool_drops_the_arriving_frame() {
+  deliver(REM_SET_TELEMETRY, 1);
+
+  // Everything else in the pool held elsewhere
+  while (frame_pool_acquire() != FRAME_POOL_INVALID_SLOT) {
+  }
+
+  deliver(REM_PAIR_INIT, 2);
+
+  TEST_ASSERT_EQUAL_UINT32(1, drop_stats.total);
+  TEST_ASSERT_EQUAL_UINT32(1, drop_stats.pairing);
+
+  // The queued frame is untouched
+  uint8_t markers[RX_QUEUE_SIZE];
+  TEST_ASSERT_EQUAL(1, drain(markers));
+  TEST_ASSERT_EQUAL_UINT8(1, markers[0]);
+}
+
+static void test_invalid_lengths_never_take_a_slot() {
+  uint8_t frame[ESP_NOW_MAX_DATA_LEN + 1] = {REM_SET_TELEMETRY};
+  wifi_pkt_rx_ctrl_t rx_ctrl = {.rssi = -60, .channel = 1};
+  esp_now_recv_info_t recv_info = {.src_addr = board_mac, .rx_ctrl = &rx_ctrl};
+
+  on_data_recv(&recv_info, frame, 0);
+  on_data_recv(&recv_info, frame, -1);
+  on_data_recv(&recv_info, frame, sizeof(frame));
+
+  TEST_ASSERT_EQUAL_UINT8(0, frame_pool_in_use());
+  TEST_ASSERT_EQUAL_UINT(0, uxQueueMessagesWaiting(espnow_queue));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_burst_keeps_newest_frames_in_order);
+  RUN_TEST(test_evicted_slots_return_to_the_pool);
+  RUN_TEST(test_drops_are_counted_by_evicted_command);
+  RUN_TEST(test_exhausted_pool_drops_the_arriving_frame);
+  RUN_TEST(test_invalid_lengths_never_take_a_slot);
+  return UNITY_END();
+}
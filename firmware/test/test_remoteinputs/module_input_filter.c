@@ -0,0 +1 @@
+#include "utilities/input_filter.c"
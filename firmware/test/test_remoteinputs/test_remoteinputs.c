@@ -0,0 +1,320 @@
+// Board pins normally come from the env, the suite builds the remote without a joystick or button
+#define I2C_SDA 0
+#define I2C_SCL 0
+#include "remote/remoteinputs.c"
+#include <stdio.h>
+#include <time.h>
+#include <unity.h>
+
+#define BENCHMARK_ITERATIONS 2000000
+#define THROUGHPUT_PATTERN_CYCLES 1024
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static PackedRemoteData pack_axes(float js_x, float js_y) {
+  RemoteData data = {.js_x = js_x, .js_y = js_y};
+  return pack_remote_data(&data);
+}
+
+static void test_pack_scales_axes(void) {
+  PackedRemoteData packed = pack_axes(0.25f, -0.73f);
+  TEST_ASSERT_EQUAL_INT8(25, packed.js_x);
+  TEST_ASSERT_EQUAL_INT8(-73, packed.js_y);
+
+  packed = pack_axes(1.0f, -1.0f);
+  TEST_ASSERT_EQUAL_INT8(100, packed.js_x);
+  TEST_ASSERT_EQUAL_INT8(-100, packed.js_y);
+
+  // Every value convert_adc_to_axis can produce survives packing exactly
+  for (int i = -100; i <= 100; i++) {
+    float axis = roundf(i / 100.0f * 100) / 100;
+    TEST_ASSERT_EQUAL_INT8(i, pack_axes(axis, 0).js_x);
+  }
+}
+
+static void test_pack_clamps_to_100(void) {
+  PackedRemoteData packed = pack_axes(1.5f, -1.5f);
+  TEST_ASSERT_EQUAL_INT8(100, packed.js_x);
+  TEST_ASSERT_EQUAL_INT8(-100, packed.js_y);
+
+  // Far outside int8, a plain cast would wrap
+  packed = pack_axes(1e6f, -1e6f);
+  TEST_ASSERT_EQUAL_INT8(100, packed.js_x);
+  TEST_ASSERT_EQUAL_INT8(-100, packed.js_y);
+
+  packed = pack_axes(INFINITY, -INFINITY);
+  TEST_ASSERT_EQUAL_INT8(100, packed.js_x);
+  TEST_ASSERT_EQUAL_INT8(-100, packed.js_y);
+
+  // Rounds up past 100 only after scaling
+  packed = pack_axes(1.004f, -1.006f);
+  TEST_ASSERT_EQUAL_INT8(100, packed.js_x);
+  TEST_ASSERT_EQUAL_INT8(-100, packed.js_y);
+}
+
+static void test_pack_folds_negative_zero(void) {
+  // An inverted centred axis is -0.0, and tiny negatives round to -0.0
+  PackedRemoteData packed = pack_axes(-0.0f, -0.004f);
+  TEST_ASSERT_EQUAL_INT8(0, packed.js_x);
+  TEST_ASSERT_EQUAL_INT8(0, packed.js_y);
+
+  uint8_t bytes[sizeof(packed)];
+  memcpy(bytes, &packed, sizeof(packed));
+  TEST_ASSERT_EQUAL_UINT8(0, bytes[0]);
+  TEST_ASSERT_EQUAL_UINT8(0, bytes[1]);
+}
+
+static void test_pack_centres_nan(void) {
+  // A max at the upper deadband edge makes convert_adc_to_axis divide 0 by 0
+  TEST_ASSERT_TRUE(isnan(convert_adc_to_axis(2058, 0, 2048, 2058, 10, 1, false)));
+
+  PackedRemoteData packed = pack_axes(NAN, -NAN);
+  TEST_ASSERT_EQUAL_INT8(0, packed.js_x);
+  TEST_ASSERT_EQUAL_INT8(0, packed.js_y);
+}
+
+static void test_pack_button_bits(void) {
+  for (int bits = 0; bits < 8; bits++) {
+    RemoteData data = {
+        .bt_c = bits & 1,
+        .bt_z = bits & 2,
+        .is_rev = bits & 4,
+    };
+    PackedRemoteData packed = pack_remote_data(&data);
+
+    uint8_t expected = 0;
+    expected |= data.bt_c ? PACKED_BUTTON_C : 0;
+    expected |= data.bt_z ? PACKED_BUTTON_Z : 0;
+    expected |= data.is_rev ? PACKED_REVERSE : 0;
+    TEST_ASSERT_EQUAL_UINT8(expected, packed.buttons);
+  }
+
+  // The wire values are fixed, receivers decode them by value
+  TEST_ASSERT_EQUAL(0x01, PACKED_BUTTON_C);
+  TEST_ASSERT_EQUAL(0x02, PACKED_BUTTON_Z);
+  TEST_ASSERT_EQUAL(0x04, PACKED_REVERSE);
+  TEST_ASSERT_EQUAL(3, sizeof(PackedRemoteData));
+}
+
+// Stick ranges seen on real remotes, deadbands from none to wide and the whole expo range the settings allow
+static const int16_t calibration_ranges[][3] = {{0, 2047, 4095}, {300, 1900, 3800}, {150, 2200, 3950}};
+static const int16_t calibration_deadbands[] = {0, 10, 60};
+static const float calibration_expos[] = {1, 1.5f, 2, 2.5f, 3};
+
+static void test_lut_matches_conversion_for_every_code(void) {
+  static AxisLut lut;
+  uint32_t checked = 0;
+
+  for (int range = 0; range < sizeof(calibration_ranges) / sizeof(calibration_ranges[0]); range++) {
+    for (int deadband = 0; deadband < sizeof(calibration_deadbands) / sizeof(calibration_deadbands[0]); deadband++) {
+      for (int expo = 0; expo < sizeof(calibration_expos) / sizeof(calibration_expos[0]); expo++) {
+        for (int invert = 0; invert <= 1; invert++) {
+          AxisCalibration calibration = {calibration_ranges[range][0], calibration_ranges[range][1],
+                                         calibration_ranges[range][2], calibration_deadbands[deadband],
+                                         calibration_expos[expo],      invert};
+          axis_lut_update(&lut, &calibration);
+
+          for (int adc_value = 0; adc_value <= STICK_MAX_VAL; adc_value++) {
+            float expected = convert_adc_to_axis(adc_value, calibration.min_val, calibration.mid_val,
+                                                 calibration.max_val, calibration.deadband, calibration.expo,
+                                                 calibration.invert);
+            float actual = axis_lut_convert(&lut, adc_value);
+            if (expected != actual) {
+              char message[128];
+              snprintf(message, sizeof(message), "code %d, range %d, deadband %d, expo %.1f, invert %d: %f != %f",
+                       adc_value, range, calibration.deadband, calibration.expo, invert, expected, actual);
+              TEST_FAIL_MESSAGE(message);
+            }
+            checked++;
+          }
+        }
+      }
+    }
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(90 * (STICK_MAX_VAL + 1), checked);
+}
+
+static void test_lut_clamps_and_centres(void) {
+  static AxisLut lut;
+  AxisCalibration calibration = {0, 2048, 4095, 10, 1, false};
+  axis_lut_update(&lut, &calibration);
+
+  // Readings outside the ADC range take the end codes
+  TEST_ASSERT_EQUAL_FLOAT(axis_lut_convert(&lut, 0), axis_lut_convert(&lut, -5));
+  TEST_ASSERT_EQUAL_FLOAT(axis_lut_convert(&lut, STICK_MAX_VAL), axis_lut_convert(&lut, STICK_MAX_VAL + 100));
+
+  // Codes where a degenerate calibration divides 0 by 0 are centred like pack_axis does
+  AxisCalibration degenerate = {0, 2048, 2058, 10, 1, false};
+  axis_lut_update(&lut, &degenerate);
+  TEST_ASSERT_TRUE(isnan(convert_adc_to_axis(2058, 0, 2048, 2058, 10, 1, false)));
+  TEST_ASSERT_EQUAL_FLOAT(0, axis_lut_convert(&lut, 2058));
+}
+
+static double elapsed_ns(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+// Per sample cost of the conversion the input task did before the table, with expo where pow dominates
+static void test_benchmark_lut_against_conversion(void) {
+  static AxisLut lut;
+  AxisCalibration calibration = {150, 2200, 3950, 10, 2.5f, true};
+  struct timespec start, end;
+  volatile float sink = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    sink += convert_adc_to_axis(i & STICK_MAX_VAL, calibration.min_val, calibration.mid_val, calibration.max_val,
+                                calibration.deadband, calibration.expo, calibration.invert);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double convert_ns = elapsed_ns(start, end) / BENCHMARK_ITERATIONS;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  lut.is_built = false;
+  axis_lut_update(&lut, &calibration);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double build_us = elapsed_ns(start, end) / 1000;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    sink += axis_lut_convert(&lut, i & STICK_MAX_VAL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double lut_ns = elapsed_ns(start, end) / BENCHMARK_ITERATIONS;
+
+  char message[128];
+  snprintf(message, sizeof(message),
+           "convert_adc_to_axis %.1f ns/sample, axis_lut_convert %.1f ns/sample, table build %.0f us", convert_ns,
+           lut_ns, build_us);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(lut_ns < convert_ns);
+}
+
+// Saved settings with distinct ranges per axis, so an axis scaled with the other axis' settings shows up
+static const CalibrationSettings golden_settings = {
+    .x_min = 310,
+    .x_max = 3870,
+    .y_min = 150,
+    .y_max = 3950,
+    .x_center = 2010,
+    .y_center = 2200,
+    .deadband = 20,
+};
+static const int golden_codes[] = {0, 200, 700, 1600, 1995, 2100, 2600, 3500, 3900, 4095};
+static const float golden_expos[] = {1, 1.5f, 2.5f};
+// Axis * 100 for golden_codes at each of golden_expos, not inverted
+static const int8_t golden_x[][10] = {
+    {-100, -100, -77, -23, 0, 4, 31, 80, 100, 100},
+    {-100, -100, -67, -11, 0, 1, 17, 71, 100, 100},
+    {-100, -100, -52, -3, 0, 0, 5, 57, 100, 100},
+};
+static const int8_t golden_y[][10] = {
+    {-100, -98, -73, -29, -9, -4, 22, 74, 97, 100},
+    {-100, -96, -62, -15, -3, -1, 10, 64, 96, 100},
+    {-100, -94, -45, -4, 0, 0, 2, 47, 93, 100},
+};
+
+static void assert_golden_axis(const AxisCalibration *calibration, const int8_t *golden, bool is_inverted,
+                               const char *name) {
+  static AxisLut lut;
+  axis_lut_update(&lut, calibration);
+
+  for (int i = 0; i < sizeof(golden_codes) / sizeof(golden_codes[0]); i++) {
+    char message[64];
+    snprintf(message, sizeof(message), "%s axis, code %d, expo %.1f", name, golden_codes[i], calibration->expo);
+    int expected = is_inverted ? -golden[i] : golden[i];
+    TEST_ASSERT_EQUAL_INT_MESSAGE(expected, pack_axis(axis_lut_convert(&lut, golden_codes[i])), message);
+  }
+}
+
+static void test_calibration_golden_axes(void) {
+  for (int expo = 0; expo < sizeof(golden_expos) / sizeof(golden_expos[0]); expo++) {
+    for (int invert = 0; invert <= 1; invert++) {
+      calibration_settings = golden_settings;
+      calibration_settings.expo = golden_expos[expo];
+      calibration_settings.invert_y = invert;
+
+      // Inverting only ever applies to Y
+      AxisCalibration x_calibration = get_x_axis_calibration();
+      assert_golden_axis(&x_calibration, golden_x[expo], false, "x");
+      AxisCalibration y_calibration = get_y_axis_calibration();
+      assert_golden_axis(&y_calibration, golden_y[expo], invert, "y");
+    }
+  }
+}
+
+// One input cycle of the thumbstick task for both axes, from raw conversions to the packed frame
+static PackedRemoteData run_input_cycle(const uint16_t *conversions, IirFilter *x_filter, IirFilter *y_filter,
+                                        const AxisLut *x_lut, const AxisLut *y_lut) {
+  const uint16_t *y_conversions = conversions + STICK_OVERSAMPLE_COUNT;
+  uint16_t x_value = iir_filter_update(x_filter, median_u16(conversions, STICK_OVERSAMPLE_COUNT));
+  uint16_t y_value = iir_filter_update(y_filter, median_u16(y_conversions, STICK_OVERSAMPLE_COUNT));
+
+  RemoteData data = {.js_x = axis_lut_convert(x_lut, x_value), .js_y = axis_lut_convert(y_lut, y_value)};
+  return pack_remote_data(&data);
+}
+
+static void test_benchmark_input_throughput(void) {
+  static AxisLut x_lut;
+  static AxisLut y_lut;
+  calibration_settings = golden_settings;
+  calibration_settings.expo = 2.5f;
+  AxisCalibration x_calibration = get_x_axis_calibration();
+  AxisCalibration y_calibration = get_y_axis_calibration();
+  axis_lut_update(&x_lut, &x_calibration);
+  axis_lut_update(&y_lut, &y_calibration);
+
+  IirFilter x_filter;
+  IirFilter y_filter;
+  iir_filter_init(&x_filter, STICK_FILTER_SHIFT);
+  iir_filter_init(&y_filter, STICK_FILTER_SHIFT);
+
+  // A stick sweeping back and forth with a few codes of noise, precomputed so only the pipeline is timed
+  static uint16_t conversions[THROUGHPUT_PATTERN_CYCLES][2 * STICK_OVERSAMPLE_COUNT];
+  uint32_t noise = 0x2545F491;
+  for (int cycle = 0; cycle < THROUGHPUT_PATTERN_CYCLES; cycle++) {
+    int position = cycle < THROUGHPUT_PATTERN_CYCLES / 2 ? cycle * 8 : (THROUGHPUT_PATTERN_CYCLES - cycle) * 8;
+    for (int i = 0; i < 2 * STICK_OVERSAMPLE_COUNT; i++) {
+      noise ^= noise << 13;
+      noise ^= noise >> 17;
+      noise ^= noise << 5;
+      conversions[cycle][i] = position + noise % 16;
+    }
+  }
+
+  struct timespec start, end;
+  volatile int sink = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    PackedRemoteData packed =
+        run_input_cycle(conversions[i % THROUGHPUT_PATTERN_CYCLES], &x_filter, &y_filter, &x_lut, &y_lut);
+    sink += packed.js_x + packed.js_y;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  double seconds = elapsed_ns(start, end) / 1e9;
+  double cycles_per_second = BENCHMARK_ITERATIONS / seconds;
+  char message[128];
+  snprintf(message, sizeof(message), "%.0f input cycles/s, %.0f samples/s, the task needs %d cycles/s",
+           cycles_per_second, cycles_per_second * 2 * STICK_OVERSAMPLE_COUNT, 1000 / INPUT_RATE_MS);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(cycles_per_second > 1000 / INPUT_RATE_MS);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_pack_scales_axes);
+  RUN_TEST(test_pack_clamps_to_100);
+  RUN_TEST(test_pack_folds_negative_zero);
+  RUN_TEST(test_pack_centres_nan);
+  RUN_TEST(test_pack_button_bits);
+  RUN_TEST(test_lut_matches_conversion_for_every_code);
+  RUN_TEST(test_lut_clamps_and_centres);
+  RUN_TEST(test_benchmark_lut_against_conversion);
+  RUN_TEST(test_calibration_golden_axes);
+  RUN_TEST(test_benchmark_input_throughput);
+  return UNITY_END();
+}
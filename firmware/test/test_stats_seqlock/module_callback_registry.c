@@ -0,0 +1 @@
+#include "utilities/callback_registry.c"
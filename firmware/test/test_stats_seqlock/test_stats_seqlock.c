@@ -0,0 +1,141 @@
+#include "remote/stats.c"
+#include <pthread.h>
+#include <unity.h>
+
+#define WRITER_UPDATES 200000
+#define READER_COUNT 2
+
+static atomic_bool is_writing;
+static atomic_uint torn_reads;
+static atomic_uint snapshots_read;
+
+void setUp(void) {
+  stats_init();
+  atomic_store(&torn_reads, 0);
+  atomic_store(&snapshots_read, 0);
+}
+
+void tearDown(void) {}
+
+// Every field written from the same counter, so a snapshot mixing two updates shows up as disagreeing fields
+static void write_generation(RemoteStats *stats, uint32_t generation) {
+  stats->lastUpdated = generation;
+  stats->speed = generation;
+  stats->maxSpeed = generation;
+  stats->dutyCycle = (uint8_t)generation;
+  stats->batteryVoltage = generation;
+  stats->batteryPercentage = (uint8_t)generation;
+  stats->remoteBatteryVoltage = (uint16_t)generation;
+  stats->tripDistance = generation;
+  stats->motorTemp = generation;
+  stats->controllerTemp = generation;
+  stats->signalStrength = generation;
+  stats->motorCurrent = generation;
+  stats->rpm = (int16_t)generation;
+  stats->odometer = generation;
+  stats->faultCode = (uint8_t)generation;
+  stats->rxPacketLoss = (uint8_t)generation;
+  stats->txPacketLoss = (uint8_t)generation;
+}
+
+static bool is_consistent(const RemoteStats *stats) {
+  uint32_t generation = (uint32_t)stats->lastUpdated;
+
+  return stats->speed == (float)generation && stats->maxSpeed == (float)generation &&
+         stats->dutyCycle == (uint8_t)generation && stats->batteryVoltage == (float)generation &&
+         stats->batteryPercentage == (uint8_t)generation && stats->remoteBatteryVoltage == (uint16_t)generation &&
+         stats->tripDistance == (float)generation && stats->motorTemp == (float)generation &&
+         stats->controllerTemp == (float)generation && stats->signalStrength == (int)generation &&
+         stats->motorCurrent == (float)generation && stats->rpm == (int16_t)generation &&
+         stats->odometer == generation && stats->faultCode == (uint8_t)generation &&
+         stats->rxPacketLoss == (uint8_t)generation && stats->txPacketLoss == (uint8_t)generation;
+}
+
+static void *write_stats(void *arg) {
+  // Below 2^24 so every generation is exact as a float
+  for (uint32_t generation = 1; generation <= WRITER_UPDATES; generation++) {
+    RemoteStats *stats = stats_begin_update();
+    write_generation(stats, generation);
+    stats_publish();
+  }
+
+  atomic_store(&is_writing, false);
+  return NULL;
+}
+
+static void *read_stats(void *arg) {
+  int64_t last_generation = 0;
+
+  while (atomic_load(&is_writing)) {
+    RemoteStats snapshot;
+    stats_read_snapshot(&snapshot);
+    atomic_fetch_add(&snapshots_read, 1);
+
+    // Torn copy, or an older snapshot than one already seen
+    if ((snapshot.lastUpdated != 0 && !is_consistent(&snapshot)) || snapshot.lastUpdated < last_generation) {
+      atomic_fetch_add(&torn_reads, 1);
+    }
+    last_generation = snapshot.lastUpdated;
+  }
+
+  return NULL;
+}
+
+static void test_snapshot_matches_last_publish() {
+  RemoteStats *stats = stats_begin_update();
+  write_generation(stats, 42);
+  stats_publish();
+
+  RemoteStats snapshot;
+  stats_read_snapshot(&snapshot);
+  TEST_ASSERT_TRUE(is_consistent(&snapshot));
+  TEST_ASSERT_EQUAL(42, snapshot.lastUpdated);
+}
+
+static void test_publish_marks_changed_fields() {
+  atomic_store(&stats_dirty_mask, STATS_FIELD_NONE);
+
+  RemoteStats *stats = stats_begin_update();
+  stats->speed = 12;
+  stats->odometer = 1000;
+  stats_publish();
+
+  TEST_ASSERT_EQUAL_UINT32(STATS_FIELD_SPEED | STATS_FIELD_ODOMETER, atomic_load(&stats_dirty_mask));
+}
+
+static void test_concurrent_readers_never_see_torn_snapshots() {
+  pthread_t writer;
+  pthread_t readers[READER_COUNT];
+  atomic_store(&is_writing, true);
+
+  for (int i = 0; i < READER_COUNT; i++) {
+    TEST_ASSERT_EQUAL(0, pthread_create(&readers[i], NULL, read_stats, NULL));
+  }
+  TEST_ASSERT_EQUAL(0, pthread_create(&writer, NULL, write_stats, NULL));
+
+  pthread_join(writer, NULL);
+  for (int i = 0; i < READER_COUNT; i++) {
+    pthread_join(readers[i], NULL);
+  }
+
+  char message[64];
+  snprintf(message, sizeof(message), "%u snapshots read during %d updates", atomic_load(&snapshots_read),
+           WRITER_UPDATES);
+  TEST_MESSAGE(message);
+
+  TEST_ASSERT_EQUAL_UINT(0, atomic_load(&torn_reads));
+  TEST_ASSERT_GREATER_THAN(0, atomic_load(&snapshots_read));
+
+  RemoteStats snapshot;
+  stats_read_snapshot(&snapshot);
+  TEST_ASSERT_EQUAL(WRITER_UPDATES, snapshot.lastUpdated);
+  TEST_ASSERT_TRUE(is_consistent(&snapshot));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_snapshot_matches_last_publish);
+  RUN_TEST(test_publish_marks_changed_fields);
+  RUN_TEST(test_concurrent_readers_never_see_torn_snapshots);
+  return UNITY_END();
+}
@@ -0,0 +1 @@
+#include "telemetry_encoder.c"
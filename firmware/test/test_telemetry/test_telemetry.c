@@ -0,0 +1,191 @@
+#include "remote/telemetry.c"
+#include "telemetry_encoder.h"
+#include <unity.h>
+
+// Every field set to a value that survives quantization exactly
+static const TelemetryData riding = {
+    .speed = 8.3f,
+    .duty_cycle = 0.42f,
+    .battery_voltage = 62.4f,
+    .battery_level = 71.5f,
+    .motor_temp = 38.5f,
+    .controller_temp = 41.0f,
+    .state = 3,
+    .switch_state = 2,
+    .trip_distance = 12345,
+    .current = -12.7f,
+    .rpm = -1234,
+    .odometer = 3456789,
+    .fault_code = 7,
+    .pitch = -2.5f,
+    .roll = 1.2f,
+};
+
+static TelemetryDecoder decoder;
+
+void setUp(void) {
+  memset(&decoder, 0, sizeof(decoder));
+  telemetry_reset();
+}
+
+void tearDown(void) {}
+
+static void assert_telemetry_equal(const TelemetryData *expected, const TelemetryData *actual) {
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, expected->speed, actual->speed);
+  TEST_ASSERT_FLOAT_WITHIN(0.005f, expected->duty_cycle, actual->duty_cycle);
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, expected->battery_voltage, actual->battery_voltage);
+  TEST_ASSERT_FLOAT_WITHIN(0.25f, expected->battery_level, actual->battery_level);
+  TEST_ASSERT_FLOAT_WITHIN(0.25f, expected->motor_temp, actual->motor_temp);
+  TEST_ASSERT_FLOAT_WITHIN(0.25f, expected->controller_temp, actual->controller_temp);
+  TEST_ASSERT_EQUAL_UINT8(expected->state, actual->state);
+  TEST_ASSERT_EQUAL_UINT8(expected->switch_state, actual->switch_state);
+  TEST_ASSERT_FLOAT_WITHIN(0.5f, expected->trip_distance, actual->trip_distance);
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, expected->current, actual->current);
+  TEST_ASSERT_EQUAL_INT16(expected->rpm, actual->rpm);
+  TEST_ASSERT_EQUAL_UINT32(expected->odometer, actual->odometer);
+  TEST_ASSERT_EQUAL_UINT8(expected->fault_code, actual->fault_code);
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, expected->pitch, actual->pitch);
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, expected->roll, actual->roll);
+}
+
+static size_t encode_keyframe(uint8_t *buf, uint8_t sequence, uint8_t keyframe_id, const TelemetryData *data) {
+  return telemetry_encode(buf, TELEMETRY_ENCODER_MAX_SIZE, TELEMETRY_FRAME_KEY, sequence, keyframe_id, 0, data);
+}
+
+static size_t encode_delta(uint8_t *buf, uint8_t sequence, uint8_t keyframe_id, const TelemetryData *keyframe,
+                           const TelemetryData *data) {
+  uint16_t mask = telemetry_encoder_diff(keyframe, data);
+  return telemetry_encode(buf, TELEMETRY_ENCODER_MAX_SIZE, TELEMETRY_FRAME_DELTA, sequence, keyframe_id, mask, data);
+}
+
+static void test_keyframe_round_trip(void) {
+  uint8_t frame[TELEMETRY_ENCODER_MAX_SIZE];
+  size_t len = encode_keyframe(frame, 42, 1, &riding);
+
+  TelemetryData out;
+  uint8_t sequence = 0;
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_OK, telemetry_decode(frame, len, &sequence, &out));
+  TEST_ASSERT_EQUAL_UINT8(42, sequence);
+  assert_telemetry_equal(&riding, &out);
+}
+
+static void test_frame_sizes(void) {
+  uint8_t frame[TELEMETRY_ENCODER_MAX_SIZE];
+
+  // The encoder and decoder agree on every field width
+  for (int field = 0; field < TELEMETRY_FIELD_COUNT; field++) {
+    size_t len = telemetry_encode(frame, sizeof(frame), TELEMETRY_FRAME_DELTA, 0, 0, 1 << field, &riding);
+    TEST_ASSERT_EQUAL(TELEMETRY_HEADER_SIZE + telemetry_field_size[field], len);
+  }
+
+  // Payload sizes, the secret code and command byte add 5 bytes on air
+  TEST_ASSERT_EQUAL(33, encode_keyframe(frame, 0, 1, &riding));
+
+  TelemetryData moving = riding;
+  moving.speed += 0.5f;
+  moving.duty_cycle += 0.03f;
+  moving.battery_voltage -= 0.2f;
+  moving.current += 1.5f;
+  moving.rpm += 40;
+  moving.pitch += 0.4f;
+  moving.roll -= 0.3f;
+  TEST_ASSERT_EQUAL(19, encode_delta(frame, 1, 1, &riding, &moving));
+
+  // Nothing changed since the keyframe, only the header is sent
+  TEST_ASSERT_EQUAL(TELEMETRY_HEADER_SIZE, encode_delta(frame, 2, 1, &riding, &riding));
+
+  // A short buffer is refused instead of overrun
+  TEST_ASSERT_EQUAL(0, telemetry_encode(frame, 32, TELEMETRY_FRAME_KEY, 0, 1, 0, &riding));
+}
+
+static void test_delta_applies_on_keyframe(void) {
+  uint8_t frame[TELEMETRY_ENCODER_MAX_SIZE];
+  TelemetryData out;
+
+  size_t len = encode_keyframe(frame, 0, 4, &riding);
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_OK, telemetry_decode_peer(&decoder, frame, len, &out));
+
+  TelemetryData first = riding;
+  first.speed = 9.1f;
+  first.fault_code = 0;
+
+  TelemetryData second = riding;
+  second.battery_level = 70.0f;
+  second.odometer += 3;
+
+  // The first delta is lost, the second only depends on the keyframe
+  encode_delta(frame, 1, 4, &riding, &first);
+  len = encode_delta(frame, 2, 4, &riding, &second);
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_OK, telemetry_decode_peer(&decoder, frame, len, &out));
+  assert_telemetry_equal(&second, &out);
+
+  // Deltas never replace the stored keyframe
+  assert_telemetry_equal(&riding, &decoder.keyframe);
+}
+
+static void test_delta_waits_for_keyframe(void) {
+  uint8_t frame[TELEMETRY_ENCODER_MAX_SIZE];
+  TelemetryData out;
+  uint8_t sequence = 0;
+  TelemetryData moving = riding;
+  moving.speed = 1.0f;
+
+  size_t len = encode_delta(frame, 7, 2, &riding, &moving);
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_MISSING_KEYFRAME, telemetry_decode(frame, len, &sequence, &out));
+  // Still counted for link loss
+  TEST_ASSERT_EQUAL_UINT8(7, sequence);
+
+  size_t key_len = encode_keyframe(frame, 1, 3, &riding);
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_OK, telemetry_decode(frame, key_len, &sequence, &out));
+
+  // Delta against an older keyframe id
+  len = encode_delta(frame, 2, 2, &riding, &moving);
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_MISSING_KEYFRAME, telemetry_decode(frame, len, &sequence, &out));
+
+  // A reset on reconnect drops the keyframe of the previous board
+  len = encode_delta(frame, 3, 3, &riding, &moving);
+  telemetry_reset();
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_MISSING_KEYFRAME, telemetry_decode(frame, len, &sequence, &out));
+}
+
+static void test_rejects_malformed_frames(void) {
+  uint8_t frame[TELEMETRY_ENCODER_MAX_SIZE];
+  TelemetryData out;
+  size_t len = encode_keyframe(frame, 0, 1, &riding);
+
+  // Every truncation and one extra byte
+  for (size_t cut = 0; cut < len; cut++) {
+    TEST_ASSERT_EQUAL(TELEMETRY_DECODE_INVALID, telemetry_decode_peer(&decoder, frame, cut, &out));
+  }
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_INVALID, telemetry_decode_peer(&decoder, frame, len + 1, &out));
+
+  frame[0] = TELEMETRY_VERSION + 1;
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_UNSUPPORTED_VERSION, telemetry_decode_peer(&decoder, frame, len, &out));
+  frame[0] = TELEMETRY_VERSION;
+
+  frame[1] = 2;
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_INVALID, telemetry_decode_peer(&decoder, frame, len, &out));
+  frame[1] = TELEMETRY_FRAME_KEY;
+
+  // Unknown mask bit
+  frame[4] |= 0x80;
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_INVALID, telemetry_decode_peer(&decoder, frame, len, &out));
+
+  // Keyframe missing a field
+  len = telemetry_encode(frame, sizeof(frame), TELEMETRY_FRAME_DELTA, 0, 1,
+                         TELEMETRY_FIELD_MASK_ALL & ~(1 << TELEMETRY_FIELD_ROLL), &riding);
+  frame[1] = TELEMETRY_FRAME_KEY;
+  TEST_ASSERT_EQUAL(TELEMETRY_DECODE_INVALID, telemetry_decode_peer(&decoder, frame, len, &out));
+
+  TEST_ASSERT_FALSE(decoder.has_keyframe);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_keyframe_round_trip);
+  RUN_TEST(test_frame_sizes);
+  RUN_TEST(test_delta_applies_on_keyframe);
+  RUN_TEST(test_delta_waits_for_keyframe);
+  RUN_TEST(test_rejects_malformed_frames);
+  return UNITY_END();
+}